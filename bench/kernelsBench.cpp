@@ -0,0 +1,113 @@
+// Микробенчмарк ядер Kernels: пропускная способность в ГБ/с для каждого набора
+// инструкций, доступного процессору, и для циклов, которые ядра заменили.
+// Запуск: kernelsBench [число значений], по умолчанию 1 000 003.
+
+#include "../kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    volatile double sink; // Не даёт компилятору выбросить замеряемый код
+
+    // Повторяет вызов не меньше 0.3 с и возвращает прочитанные байты в секунду
+    template <typename F>
+    double gigabytesPerSecond(F f, std::size_t size)
+    {
+        const Clock::time_point start = Clock::now();
+        std::size_t reps = 0;
+        double seconds = 0.0;
+        do {
+            sink = f();
+            ++reps;
+            seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (seconds < 0.3);
+        return double(size) * sizeof(double) * reps / seconds / 1e9;
+    }
+
+    // Прежние реализации из Calculate: накопление в long double по одному значению
+    namespace Baseline
+    {
+        double sum(const std::vector<double>& values)
+        {
+            return static_cast<double>(std::accumulate(values.begin(), values.end(), 0.0L));
+        }
+
+        double minMax(const std::vector<double>& values)
+        {
+            return *std::min_element(values.begin(), values.end()) + *std::max_element(values.begin(), values.end());
+        }
+
+        double fourthPowerSum(const std::vector<double>& values, double mean)
+        {
+            long double sum = 0.0L;
+            for (double value : values)
+                sum += std::pow(static_cast<long double>(value) - mean, 4.0L);
+            return static_cast<double>(sum);
+        }
+
+        double reciprocalSum(const std::vector<double>& values)
+        {
+            long double sum = 0.0L;
+            for (double value : values)
+                sum += 1.0L / static_cast<long double>(value);
+            return static_cast<double>(sum);
+        }
+
+        double logSum(const std::vector<double>& values)
+        {
+            long double sum = 0.0L;
+            for (double value : values)
+                sum += std::log(static_cast<long double>(value));
+            return static_cast<double>(sum);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t size = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000003;
+
+    // Положительные значения с большим общим смещением: худший случай для суммы в double
+    std::mt19937 generator(1);
+    std::lognormal_distribution<double> distribution(3.0, 0.5);
+    std::vector<double> values(size);
+    for (double& value : values)
+        value = distribution(generator) + 1e6;
+    const double* data = values.data();
+    const double center = 1e6;
+
+    std::printf("%zu values, GB/s\n", size);
+    std::printf("%-10s %10s %10s %10s %10s %10s\n", "", "sum", "min+max", "powers", "reciprocal", "log");
+
+    for (Kernels::Isa isa : {Kernels::Isa::Scalar, Kernels::Isa::Sse2, Kernels::Isa::Avx2, Kernels::Isa::Avx512}) {
+        if (!Kernels::setIsa(isa)) {
+            std::printf("%-10s not supported by this CPU\n", Kernels::isaName(isa));
+            continue;
+        }
+        std::printf("%-10s %10.2f %10.2f %10.2f %10.2f %10.2f\n", Kernels::isaName(isa),
+                    gigabytesPerSecond([&] { return Kernels::sum(data, size); }, size),
+                    gigabytesPerSecond([&] { return Kernels::minMax(data, size).min; }, size),
+                    gigabytesPerSecond([&] { return Kernels::centralPowerSums(data, size, center).s4; }, size),
+                    gigabytesPerSecond([&] { return Kernels::reciprocalSum(data, size); }, size),
+                    gigabytesPerSecond([&] { return Kernels::logSum(data, size); }, size));
+    }
+    Kernels::setIsa(Kernels::detectIsa());
+
+    std::printf("%-10s %10.2f %10.2f %10.2f %10.2f %10.2f\n", "baseline",
+                gigabytesPerSecond([&] { return Baseline::sum(values); }, size),
+                gigabytesPerSecond([&] { return Baseline::minMax(values); }, size),
+                gigabytesPerSecond([&] { return Baseline::fourthPowerSum(values, center); }, size),
+                gigabytesPerSecond([&] { return Baseline::reciprocalSum(values); }, size),
+                gigabytesPerSecond([&] { return Baseline::logSum(values); }, size));
+    return 0;
+}
@@ -11,7 +11,7 @@ namespace Calculate
         return (weights.size() == values.size()) && !weights.isEmpty();
     }
 
-    std::vector<double> getWeights(const QTableWidget *table, int weightColumn = 1)
+    std::vector<double> getWeights(const TableModel *table, int weightColumn = 1)
     {
         std::vector<double> weights;
         if (!table || weightColumn >= table->columnCount() || weightColumn < 0)
@@ -19,220 +19,501 @@ namespace Calculate
 
         for (int row = 0; row < table->rowCount(); ++row)
         {
-            QTableWidgetItem *item = table->item(row, weightColumn);
-            if (item && !item->text().isEmpty())
+            if (!table->hasValue(row, weightColumn))
             {
-                bool ok;
-                double weight = item->text().toDouble(&ok);
-                if (ok && weight >= 0 && std::isfinite(weight))
-                {
-                    weights.push_back(weight);
-                }
-                else
-                {
-                    qWarning() << "Invalid weight found in row" << row << "column" << weightColumn;
-                    return std::vector<double>();
-                }
+                qWarning() << "Empty weight cell found in row" << row << "column" << weightColumn;
+                return std::vector<double>();
+            }
+
+            const double weight = table->rowData(row)[weightColumn];
+            if (weight >= 0 && std::isfinite(weight))
+            {
+                weights.push_back(weight);
             }
             else
             {
-                qWarning() << "Empty weight cell found in row" << row << "column" << weightColumn;
+                qWarning() << "Invalid weight found in row" << row << "column" << weightColumn;
                 return std::vector<double>();
             }
         }
         return weights;
     }
 
-    double getSum(const std::vector<double> &values)
+    MomentAccumulator::MomentAccumulator(const std::vector<double> &values)
     {
-        long double sum = std::accumulate(values.begin(), values.end(), 0.0L);
-        if (!std::isfinite(sum))
-            return std::numeric_limits<double>::quiet_NaN();
-        return static_cast<double>(sum);
+        add(values.data(), values.size());
     }
 
-    double getMean(const std::vector<double> &values)
+    void MomentAccumulator::add(double value)
     {
-        if (values.empty())
+        if (!std::isfinite(value))
         {
-            return std::numeric_limits<double>::quiet_NaN();
+            nonFinite++;
+            return;
         }
-        long double sum = std::accumulate(values.begin(), values.end(), 0.0L);
-        if (!std::isfinite(sum))
-            return std::numeric_limits<double>::quiet_NaN();
-        return static_cast<double>(sum / values.size());
-    }
 
-    double getMedian(const std::vector<double> &values)
-    {
-        if (values.empty())
-            return std::numeric_limits<double>::quiet_NaN();
+        const double n1 = static_cast<double>(count);
+        count++;
+        const double n = static_cast<double>(count);
 
-        std::vector<double> sorted = values;
-        sorted.erase(std::remove_if(sorted.begin(), sorted.end(), [](double d)
-                                    { return !std::isfinite(d); }),
-                     sorted.end());
+        const double delta = value - mean;
+        const double deltaN = delta / n;
+        const double deltaN2 = deltaN * deltaN;
+        const double term1 = delta * deltaN * n1;
 
-        if (sorted.empty())
-            return std::numeric_limits<double>::quiet_NaN();
+        mean += deltaN;
+        m4 += term1 * deltaN2 * (n * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * m2 - 4.0 * deltaN * m3;
+        m3 += term1 * deltaN * (n - 2.0) - 3.0 * deltaN * m2;
+        m2 += term1;
 
-        std::sort(sorted.begin(), sorted.end());
+        sum.add(value);
+        min = std::min(min, value);
+        max = std::max(max, value);
 
-        const int size = sorted.size();
-        const int mid = size / 2;
+        // Логарифмы и обратные величины имеют смысл только для положительных выборок
+        if (min > 0.0)
+        {
+            logSum.add(std::log(value));
+            reciprocalSum.add(1.0 / value);
+        }
+    }
 
-        if (size % 2 == 0)
+    void MomentAccumulator::merge(const MomentAccumulator &other)
+    {
+        nonFinite += other.nonFinite;
+        if (other.count == 0)
+            return;
+        if (count == 0)
         {
-            long double median_val = (static_cast<long double>(sorted[mid - 1]) + static_cast<long double>(sorted[mid])) / 2.0L;
-            if (!std::isfinite(median_val))
-                return std::numeric_limits<double>::quiet_NaN();
-            return static_cast<double>(median_val);
+            const std::size_t skipped = nonFinite;
+            *this = other;
+            nonFinite = skipped;
+            return;
         }
-        else
+
+        // Объединение центральных моментов двух выборок (Пебэй, 2008)
+        const double nA = static_cast<double>(count);
+        const double nB = static_cast<double>(other.count);
+        const double n = nA + nB;
+        const double delta = other.mean - mean;
+        const double delta2 = delta * delta;
+
+        const double newM4 = m4 + other.m4 +
+                             delta2 * delta2 * nA * nB * (nA * nA - nA * nB + nB * nB) / (n * n * n) +
+                             6.0 * delta2 * (nA * nA * other.m2 + nB * nB * m2) / (n * n) +
+                             4.0 * delta * (nA * other.m3 - nB * m3) / n;
+        const double newM3 = m3 + other.m3 +
+                             delta2 * delta * nA * nB * (nA - nB) / (n * n) +
+                             3.0 * delta * (nA * other.m2 - nB * m2) / n;
+        m2 += other.m2 + delta2 * nA * nB / n;
+        m3 = newM3;
+        m4 = newM4;
+        mean += delta * nB / n;
+        count += other.count;
+
+        sum.add(other.sum.sum);
+        sum.add(other.sum.compensation);
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+
+        if (min > 0.0)
         {
-            return sorted[mid];
+            logSum.add(other.logSum.sum);
+            logSum.add(other.logSum.compensation);
+            reciprocalSum.add(other.reciprocalSum.sum);
+            reciprocalSum.add(other.reciprocalSum.compensation);
         }
     }
 
-    double getMode(const std::vector<double> &values)
+    void MomentAccumulator::add(const double *data, std::size_t size)
     {
-        if (values.empty())
-            return std::numeric_limits<double>::quiet_NaN();
+        // Блок помещается в L1: несколько векторных проходов по нему
+        // стоят как один проход по памяти
+        constexpr std::size_t BLOCK_SIZE = 2048;
 
-        std::map<double, int> frequencyMap;
-        for (double value : values)
+        for (std::size_t offset = 0; offset < size; offset += BLOCK_SIZE)
         {
-            if (std::isfinite(value))
+            const double *block = data + offset;
+            const std::size_t blockSize = std::min(BLOCK_SIZE, size - offset);
+
+            // Конечная сумма гарантирует, что в блоке нет inf и nan
+            const double blockSum = Kernels::sum(block, blockSize);
+            if (!std::isfinite(blockSum))
             {
-                frequencyMap[value]++;
+                for (std::size_t i = 0; i < blockSize; ++i)
+                    add(block[i]);
+                continue;
             }
+
+            MomentAccumulator part;
+            part.count = blockSize;
+            part.sum.sum = blockSum;
+
+            const Kernels::MinMax bounds = Kernels::minMax(block, blockSize);
+            part.min = bounds.min;
+            part.max = bounds.max;
+
+            // Моменты относительно среднего блока с поправкой на остаток Σ(x-c)
+            const double center = blockSum / blockSize;
+            const Kernels::PowerSums sums = Kernels::centralPowerSums(block, blockSize, center);
+            const double d = sums.s1 / blockSize;
+            part.mean = center + d;
+            part.m2 = sums.s2 - blockSize * d * d;
+            part.m3 = sums.s3 - 3.0 * d * sums.s2 + 2.0 * blockSize * d * d * d;
+            part.m4 = sums.s4 - 4.0 * d * sums.s3 + 6.0 * d * d * sums.s2 - 3.0 * blockSize * d * d * d * d;
+
+            if (min > 0.0 && bounds.min > 0.0)
+            {
+                part.reciprocalSum.sum = Kernels::reciprocalSum(block, blockSize);
+                part.logSum.sum = bounds.min >= std::numeric_limits<double>::min()
+                                      ? Kernels::logSum(block, blockSize)
+                                      : std::accumulate(block, block + blockSize, 0.0,
+                                                        [](double acc, double x) { return acc + std::log(x); });
+            }
+
+            merge(part);
         }
+    }
+
+    double getSum(const MomentAccumulator &moments)
+    {
+        const double sum = moments.sum.value();
+        if (moments.nonFinite > 0 || !std::isfinite(sum))
+            return std::numeric_limits<double>::quiet_NaN();
+        return sum;
+    }
+
+    double getSum(const std::vector<double> &values)
+    {
+        return getSum(MomentAccumulator(values));
+    }
 
-        if (frequencyMap.empty())
+    double getMean(const MomentAccumulator &moments)
+    {
+        if (moments.count == 0 || moments.nonFinite > 0)
             return std::numeric_limits<double>::quiet_NaN();
 
-        int maxFrequency = 0;
-        double mode = std::numeric_limits<double>::quiet_NaN();
-        bool multipleModes = false;
+        const double sum = moments.sum.value();
+        if (!std::isfinite(sum))
+            return std::numeric_limits<double>::quiet_NaN();
+        return sum / moments.count;
+    }
 
-        for (const auto &pair : frequencyMap)
+    double getMean(const std::vector<double> &values)
+    {
+        return getMean(MomentAccumulator(values));
+    }
+
+    SortedSample::SortedSample(const std::vector<double> &data)
+    {
+        values.reserve(data.size());
+        std::copy_if(data.begin(), data.end(), std::back_inserter(values),
+                     [](double d) { return std::isfinite(d); });
+        std::sort(values.begin(), values.end());
+    }
+
+    std::vector<double> finiteCopy(const std::vector<double> &values)
+    {
+        std::vector<double> finite;
+        finite.reserve(values.size());
+        std::copy_if(values.begin(), values.end(), std::back_inserter(finite),
+                     [](double d) { return std::isfinite(d); });
+        return finite;
+    }
+
+    // Ставит на свои места все порядковые статистики с рангами [rankFirst, rankLast)
+    // (ранги по возрастанию, без повторов). Между соседними рангами остаются
+    // ровно элементы соответствующего диапазона, хотя и неупорядоченные.
+    void selectRanks(std::vector<double>::iterator first, std::vector<double>::iterator last,
+                     const std::size_t *rankFirst, const std::size_t *rankLast, std::size_t offset)
+    {
+        while (rankFirst != rankLast && first != last)
         {
-            if (pair.second > maxFrequency)
+            const std::size_t *pivotRank = rankFirst + (rankLast - rankFirst) / 2;
+            auto pivot = first + (*pivotRank - offset);
+            std::nth_element(first, pivot, last);
+
+            // Меньшую половину рангов обрабатываем рекурсивно, большую — в цикле
+            if (pivotRank - rankFirst < rankLast - pivotRank - 1)
             {
-                maxFrequency = pair.second;
-                mode = pair.first;
-                multipleModes = false;
+                selectRanks(first, pivot, rankFirst, pivotRank, offset);
+                offset = *pivotRank + 1;
+                first = pivot + 1;
+                rankFirst = pivotRank + 1;
             }
-            else if (pair.second == maxFrequency)
+            else
             {
-                multipleModes = true;
+                selectRanks(pivot + 1, last, pivotRank + 1, rankLast, *pivotRank + 1);
+                last = pivot;
+                rankLast = pivotRank;
             }
         }
+    }
+
+    void selectRanks(std::vector<double> &values, std::vector<std::size_t> ranks)
+    {
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+        selectRanks(values.begin(), values.end(), ranks.data(), ranks.data() + ranks.size(), 0);
+    }
+
+    // Позиция квантиля p в упорядоченной выборке размера size: ранг и доля до следующего
+    std::pair<std::size_t, double> quantilePosition(std::size_t size, double p)
+    {
+        const double h = (size - 1) * p;
+        const std::size_t rank = std::min(static_cast<std::size_t>(h), size - 1);
+        return {rank, h - rank};
+    }
+
+    double interpolateQuantile(double low, double high, double fraction)
+    {
+        if (fraction <= 0.0)
+            return low;
+        const double value = low + (high - low) * fraction;
+        return std::isfinite(value) ? value : std::numeric_limits<double>::quiet_NaN();
+    }
 
-        if (maxFrequency <= 1 || multipleModes)
+    std::vector<double> quantiles(const std::vector<double> &values, const std::vector<double> &probabilities)
+    {
+        std::vector<double> work = finiteCopy(values);
+        std::vector<double> result(probabilities.size(), std::numeric_limits<double>::quiet_NaN());
+        if (work.empty())
+            return result;
+
+        const std::size_t size = work.size();
+        std::vector<std::size_t> ranks;
+        ranks.reserve(probabilities.size() * 2);
+        for (double p : probabilities)
         {
-            return std::numeric_limits<double>::quiet_NaN();
+            if (!(p >= 0.0 && p <= 1.0))
+                continue;
+            const auto [rank, fraction] = quantilePosition(size, p);
+            ranks.push_back(rank);
+            if (fraction > 0.0 && rank + 1 < size)
+                ranks.push_back(rank + 1);
         }
+        selectRanks(work, ranks);
 
-        return mode;
+        for (std::size_t i = 0; i < probabilities.size(); ++i)
+        {
+            const double p = probabilities[i];
+            if (!(p >= 0.0 && p <= 1.0))
+                continue;
+            const auto [rank, fraction] = quantilePosition(size, p);
+            const double high = rank + 1 < size ? work[rank + 1] : work[rank];
+            result[i] = interpolateQuantile(work[rank], high, fraction);
+        }
+        return result;
     }
 
-    double getStandardDeviation(const std::vector<double> &values, double mean)
+    std::vector<double> quantiles(const SortedSample &sorted, const std::vector<double> &probabilities)
     {
-        const int n = values.size();
-        if (n < 2 || std::isnan(mean))
-            return std::numeric_limits<double>::quiet_NaN();
+        std::vector<double> result(probabilities.size(), std::numeric_limits<double>::quiet_NaN());
+        if (sorted.empty())
+            return result;
 
-        long double sumSqDifferences = 0.0L;
-        long double mean_ld = static_cast<long double>(mean);
-        int validCount = 0;
+        const std::vector<double> &values = sorted.values;
+        for (std::size_t i = 0; i < probabilities.size(); ++i)
+        {
+            const double p = probabilities[i];
+            if (!(p >= 0.0 && p <= 1.0))
+                continue;
+            const auto [rank, fraction] = quantilePosition(values.size(), p);
+            const double high = rank + 1 < values.size() ? values[rank + 1] : values[rank];
+            result[i] = interpolateQuantile(values[rank], high, fraction);
+        }
+        return result;
+    }
 
-        for (double value : values)
+    double getMedian(const SortedSample &sorted)
+    {
+        return quantiles(sorted, {0.5}).front();
+    }
+
+    double getMedian(const std::vector<double> &values)
+    {
+        return quantiles(values, {0.5}).front();
+    }
+
+    // Хэш-функции ключей для открытой адресации
+    std::size_t hashKey(double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        // Финализатор splitmix64: соседние значения расходятся по всей таблице
+        bits ^= bits >> 30;
+        bits *= 0xbf58476d1ce4e5b9ULL;
+        bits ^= bits >> 27;
+        bits *= 0x94d049bb133111ebULL;
+        bits ^= bits >> 31;
+        return static_cast<std::size_t>(bits);
+    }
+
+    std::size_t hashKey(const QString &value)
+    {
+        return qHash(value);
+    }
+
+    // Подсчёт различных ключей линейным пробированием. Ячейки хранят номер ключа
+    // в keys, поэтому на элемент не выделяется память, а рост таблицы — это
+    // только перестановка номеров. Возвращает частоты по номерам ключей.
+    template<typename Key, typename Accept>
+    std::vector<std::size_t> countKeys(const std::vector<Key> &input, std::vector<Key> &keys, Accept accept)
+    {
+        constexpr std::uint32_t empty = std::numeric_limits<std::uint32_t>::max();
+        std::vector<std::size_t> counts;
+        std::vector<std::uint32_t> slots(16, empty);
+        std::size_t mask = slots.size() - 1;
+
+        for (const Key &value : input)
         {
-            if (std::isfinite(value))
+            if (!accept(value))
+                continue;
+
+            std::size_t slot = hashKey(value) & mask;
+            while (slots[slot] != empty && !(keys[slots[slot]] == value))
+                slot = (slot + 1) & mask;
+
+            if (slots[slot] != empty)
             {
-                long double diff = static_cast<long double>(value) - mean_ld;
-                sumSqDifferences += diff * diff;
-                validCount++;
+                counts[slots[slot]]++;
+                continue;
             }
-        }
 
-        if (validCount < 2)
-            return std::numeric_limits<double>::quiet_NaN();
+            slots[slot] = static_cast<std::uint32_t>(keys.size());
+            keys.push_back(value);
+            counts.push_back(1);
 
-        long double variance = sumSqDifferences / (validCount - 1);
+            // Заполненность не выше 1/2, чтобы цепочки пробирования оставались короткими
+            if (keys.size() * 2 > slots.size())
+            {
+                slots.assign(slots.size() * 2, empty);
+                mask = slots.size() - 1;
+                for (std::uint32_t id = 0; id < keys.size(); ++id)
+                {
+                    std::size_t s = hashKey(keys[id]) & mask;
+                    while (slots[s] != empty)
+                        s = (s + 1) & mask;
+                    slots[s] = id;
+                }
+            }
+        }
+        return counts;
+    }
 
-        if (variance < 0.0L || !std::isfinite(variance))
+    FrequencyTable::FrequencyTable(const std::vector<double> &values)
+    {
+        std::vector<double> normalized;
+        const std::vector<double> *source = &values;
+        // -0.0 и 0.0 равны, но различаются битами: приводим к одному ключу
+        if (std::any_of(values.begin(), values.end(), [](double v) { return v == 0.0 && std::signbit(v); }))
         {
-            return std::numeric_limits<double>::quiet_NaN();
+            normalized = values;
+            for (double &v : normalized)
+                if (v == 0.0) v = 0.0;
+            source = &normalized;
         }
 
-        long double stdDev_ld = std::sqrt(variance);
+        counts = countKeys(*source, keys, [](double v) { return std::isfinite(v); });
+        total = std::accumulate(counts.begin(), counts.end(), std::size_t{0});
+    }
 
-        if (!std::isfinite(stdDev_ld))
-            return std::numeric_limits<double>::quiet_NaN();
-        return static_cast<double>(stdDev_ld);
+    FrequencyTable::FrequencyTable(const std::vector<QString> &values)
+    {
+        counts = countKeys(values, categories, [](const QString &) { return true; });
+        total = values.size();
     }
 
-    double geometricMean(const std::vector<double> &values)
+    std::size_t FrequencyTable::maxFrequency() const
     {
-        if (values.empty())
+        return counts.empty() ? 0 : *std::max_element(counts.begin(), counts.end());
+    }
+
+    double getMode(const FrequencyTable &frequencies)
+    {
+        if (frequencies.keys.empty())
             return std::numeric_limits<double>::quiet_NaN();
 
-        long double logSum = 0.0L;
-        for (double value : values)
-        {
-            if (value <= 0)
-                return std::numeric_limits<double>::quiet_NaN();
-            logSum += std::log(static_cast<long double>(value));
-        }
+        const std::size_t maxFrequency = frequencies.maxFrequency();
+        if (maxFrequency <= 1)
+            return std::numeric_limits<double>::quiet_NaN();
 
-        if (!std::isfinite(logSum))
-        {
+        // Несколько мод — моды нет
+        if (std::count(frequencies.counts.begin(), frequencies.counts.end(), maxFrequency) > 1)
             return std::numeric_limits<double>::quiet_NaN();
-        }
 
-        long double meanLog = logSum / values.size();
-        long double result = std::exp(meanLog);
+        const auto it = std::find(frequencies.counts.begin(), frequencies.counts.end(), maxFrequency);
+        return frequencies.keys[it - frequencies.counts.begin()];
+    }
 
-        if (!std::isfinite(result) || result > std::numeric_limits<double>::max() || result < std::numeric_limits<double>::lowest())
-        {
+    double getMode(const std::vector<double> &values)
+    {
+        return getMode(FrequencyTable(values));
+    }
+
+    double getStandardDeviation(const MomentAccumulator &moments)
+    {
+        if (moments.count < 2 || moments.nonFinite > 0)
             return std::numeric_limits<double>::quiet_NaN();
-        }
 
-        return static_cast<double>(result);
+        const double variance = moments.m2 / (moments.count - 1);
+        if (variance < 0.0 || !std::isfinite(variance))
+            return std::numeric_limits<double>::quiet_NaN();
+
+        return std::sqrt(variance);
     }
 
-    double harmonicMean(const std::vector<double> &values)
+    double getStandardDeviation(const std::vector<double> &values)
+    {
+        return getStandardDeviation(MomentAccumulator(values));
+    }
+
+    double geometricMean(const MomentAccumulator &moments)
     {
-        if (values.empty())
+        if (moments.count == 0 || moments.nonFinite > 0 || moments.min <= 0)
             return std::numeric_limits<double>::quiet_NaN();
 
-        long double reciprocalSum = 0.0L;
-        for (double value : values)
-        {
-            if (value <= 0)
-                return std::numeric_limits<double>::quiet_NaN();
-            if (value < std::numeric_limits<double>::epsilon())
-            {
-                qWarning() << "Harmonic mean calculation: value near zero encountered.";
-                return std::numeric_limits<double>::quiet_NaN();
-            }
-            reciprocalSum += 1.0L / static_cast<long double>(value);
-        }
+        const double logSum = moments.logSum.value();
+        if (!std::isfinite(logSum))
+            return std::numeric_limits<double>::quiet_NaN();
 
-        if (reciprocalSum < std::numeric_limits<long double>::epsilon() || !std::isfinite(reciprocalSum))
+        const double result = std::exp(logSum / moments.count);
+        if (!std::isfinite(result))
+            return std::numeric_limits<double>::quiet_NaN();
+
+        return result;
+    }
+
+    double geometricMean(const std::vector<double> &values)
+    {
+        return geometricMean(MomentAccumulator(values));
+    }
+
+    double harmonicMean(const MomentAccumulator &moments)
+    {
+        if (moments.count == 0 || moments.nonFinite > 0 || moments.min <= 0)
+            return std::numeric_limits<double>::quiet_NaN();
+
+        if (moments.min < std::numeric_limits<double>::epsilon())
         {
+            qWarning() << "Harmonic mean calculation: value near zero encountered.";
             return std::numeric_limits<double>::quiet_NaN();
         }
 
-        long double result = static_cast<long double>(values.size()) / reciprocalSum;
+        const double reciprocalSum = moments.reciprocalSum.value();
+        if (reciprocalSum < std::numeric_limits<double>::epsilon() || !std::isfinite(reciprocalSum))
+            return std::numeric_limits<double>::quiet_NaN();
 
+        const double result = moments.count / reciprocalSum;
         if (!std::isfinite(result))
-        {
             return std::numeric_limits<double>::quiet_NaN();
-        }
-        return static_cast<double>(result);
+
+        return result;
+    }
+
+    double harmonicMean(const std::vector<double> &values)
+    {
+        return harmonicMean(MomentAccumulator(values));
     }
 
     double weightedMean(const std::vector<double> &values, const std::vector<double> &weights)
@@ -269,7 +550,7 @@ namespace Calculate
         return sumProducts / sumWeights;
     }
 
-    std::vector<double> findWeights(const QTableWidget *table)
+    std::vector<double> findWeights(const TableModel *table)
     {
         const int colCount = table->columnCount();
 
@@ -280,16 +561,8 @@ namespace Calculate
 
             for (int row = 0; row < table->rowCount(); ++row)
             {
-                QTableWidgetItem *item = table->item(row, col);
-                if (!item || item->text().isEmpty())
-                {
-                    validColumn = false;
-                    break;
-                }
-
-                bool ok;
-                const double value = item->text().toDouble(&ok);
-                if (!ok || value < 0)
+                const double value = table->rowData(row)[col];
+                if (!table->hasValue(row, col) || value < 0)
                 {
                     validColumn = false;
                     break;
@@ -309,74 +582,85 @@ namespace Calculate
         return std::vector<double>(table->rowCount(), 1.0);
     }
 
-    double rootMeanSquare(const std::vector<double> &values)
+    double rootMeanSquare(const MomentAccumulator &moments)
     {
-        if (values.empty())
+        if (moments.count == 0 || moments.nonFinite > 0)
             return std::numeric_limits<double>::quiet_NaN();
 
-        std::vector<double> squares(values.size());
-        std::transform(values.begin(), values.end(), squares.begin(), [](double x)
-                       { return x * x; });
-        double sumSquares = std::accumulate(squares.begin(), squares.end(), 0.0);
-        return std::sqrt(sumSquares / values.size());
+        // Σx² = M2 + n·x̄², оба слагаемых неотрицательны
+        const double sumSquares = moments.m2 + moments.count * moments.mean * moments.mean;
+        return std::sqrt(sumSquares / moments.count);
     }
 
-    double skewness(const std::vector<double> &values, double mean, double stdDev)
+    double rootMeanSquare(const std::vector<double> &values)
     {
-        const int n = values.size();
-        if (n < 3 || stdDev == 0)
-            return std::numeric_limits<double>::quiet_NaN();
+        return rootMeanSquare(MomentAccumulator(values));
+    }
 
-        double sumCubedDeviations = 0.0;
-        for (double value : values)
-        {
-            sumCubedDeviations += std::pow(value - mean, 3);
-        }
+    double skewness(const MomentAccumulator &moments)
+    {
+        const double stdDev = getStandardDeviation(moments);
+        const double n = static_cast<double>(moments.count);
+        if (moments.count < 3 || std::isnan(stdDev) || stdDev == 0)
+            return std::numeric_limits<double>::quiet_NaN();
 
-        const double factor = n / static_cast<double>((n - 1) * (n - 2));
-        return factor * (sumCubedDeviations / std::pow(stdDev, 3));
+        const double factor = n / ((n - 1.0) * (n - 2.0));
+        return factor * (moments.m3 / (stdDev * stdDev * stdDev));
     }
 
-    double kurtosis(const std::vector<double> &values, double mean, double stdDev)
+    double skewness(const std::vector<double> &values)
     {
-        const int n = values.size();
-        const long double n_ld = static_cast<long double>(n);
+        return skewness(MomentAccumulator(values));
+    }
 
-        if (n < 4 || stdDev == 0 || std::abs(stdDev) < std::numeric_limits<double>::epsilon())
+    double kurtosis(const MomentAccumulator &moments)
+    {
+        const double stdDev = getStandardDeviation(moments);
+        const double n = static_cast<double>(moments.count);
+        if (moments.count < 4 || std::isnan(stdDev) || stdDev < std::numeric_limits<double>::epsilon())
             return std::numeric_limits<double>::quiet_NaN();
 
-        long double sumFourthDeviations = 0.0L;
-        const long double mean_ld = static_cast<long double>(mean);
+        const double variance = stdDev * stdDev;
+        const double stdDevPow4 = variance * variance;
+        if (stdDevPow4 < std::numeric_limits<double>::epsilon())
+            return std::numeric_limits<double>::quiet_NaN();
 
-        for (double value : values)
-        {
-            long double deviation = static_cast<long double>(value) - mean_ld;
-            sumFourthDeviations += std::pow(deviation, 4.0L);
-        }
+        const double term1 = (n * (n + 1.0)) / ((n - 1.0) * (n - 2.0) * (n - 3.0));
+        const double term2 = moments.m4 / stdDevPow4;
+        const double term3 = (3.0 * (n - 1.0) * (n - 1.0)) / ((n - 2.0) * (n - 3.0));
 
-        const long double stdDev_ld = static_cast<long double>(stdDev);
-        if (stdDev_ld < std::numeric_limits<long double>::epsilon())
-        {
+        const double kurt = term1 * term2 - term3;
+        if (!std::isfinite(kurt))
             return std::numeric_limits<double>::quiet_NaN();
-        }
-        long double stdDevPow4 = std::pow(stdDev_ld, 4.0L);
-        if (stdDevPow4 < std::numeric_limits<long double>::epsilon())
-        {
+
+        return kurt;
+    }
+
+    double kurtosis(const std::vector<double> &values)
+    {
+        return kurtosis(MomentAccumulator(values));
+    }
+
+    double trimmedMean(const SortedSample &sorted, double trimFraction = 0.1)
+    {
+        if (sorted.empty() || trimFraction < 0 || trimFraction >= 0.5)
             return std::numeric_limits<double>::quiet_NaN();
-        }
 
-        long double term1 = (n_ld * (n_ld + 1.0L)) / ((n_ld - 1.0L) * (n_ld - 2.0L) * (n_ld - 3.0L));
-        long double term2 = sumFourthDeviations / stdDevPow4;
-        long double term3 = (3.0L * std::pow(n_ld - 1.0L, 2.0L)) / ((n_ld - 2.0L) * (n_ld - 3.0L));
+        const std::vector<double> &values = sorted.values;
+        const std::size_t removeCount = static_cast<std::size_t>(values.size() * trimFraction);
+        const std::size_t start = removeCount;
+        const std::size_t end = values.size() - removeCount;
 
-        long double kurt = term1 * term2 - term3;
+        if (start >= end)
+            return std::numeric_limits<double>::quiet_NaN();
 
-        if (!std::isfinite(kurt))
+        NeumaierSum sum;
+        for (std::size_t i = start; i < end; ++i)
         {
-            return std::numeric_limits<double>::quiet_NaN();
+            sum.add(values[i]);
         }
 
-        return static_cast<double>(kurt);
+        return sum.value() / (end - start);
     }
 
     double trimmedMean(const std::vector<double> &values, double trimFraction = 0.1)
@@ -384,113 +668,158 @@ namespace Calculate
         if (values.empty() || trimFraction < 0 || trimFraction >= 0.5)
             return std::numeric_limits<double>::quiet_NaN();
 
-        std::vector<double> sorted = values;
-        std::sort(sorted.begin(), sorted.end());
-
-        const int removeCount = static_cast<int>(sorted.size() * trimFraction);
-        const int start = removeCount;
-        const int end = sorted.size() - removeCount;
+        std::vector<double> work = finiteCopy(values);
+        const std::size_t removeCount = static_cast<std::size_t>(work.size() * trimFraction);
+        const std::size_t start = removeCount;
+        const std::size_t end = work.size() - removeCount;
 
         if (start >= end)
             return std::numeric_limits<double>::quiet_NaN();
 
-        double sum = 0.0;
-        for (int i = start; i < end; ++i)
+        // После выбора границ внутри [start, end) остаются ровно неусечённые значения
+        selectRanks(work, {start, end - 1});
+
+        NeumaierSum sum;
+        for (std::size_t i = start; i < end; ++i)
         {
-            sum += sorted[i];
+            sum.add(work[i]);
         }
 
-        return sum / (end - start);
+        return sum.value() / (end - start);
     }
 
-    double medianAbsoluteDeviation(const std::vector<double> &values)
+    double medianAbsoluteDeviation(const SortedSample &sorted)
     {
-        if (values.empty())
+        if (sorted.empty())
             return std::numeric_limits<double>::quiet_NaN();
 
-        std::vector<double> sorted = values;
-        std::sort(sorted.begin(), sorted.end());
+        const std::vector<double> &values = sorted.values;
         const double median = getMedian(sorted);
+        if (std::isnan(median))
+            return std::numeric_limits<double>::quiet_NaN();
 
-        std::vector<double> deviations;
-        for (double value : values)
+        // Отклонения слева от медианы (читаем назад) и справа (читаем вперёд)
+        // уже упорядочены — сливаем две последовательности до середины без сортировки
+        const std::size_t size = values.size();
+        std::size_t left = std::lower_bound(values.begin(), values.end(), median) - values.begin();
+        std::size_t right = left;
+        const std::size_t lowRank = (size - 1) / 2;
+        const std::size_t highRank = size / 2;
+
+        double lowValue = 0.0;
+        double current = 0.0;
+        for (std::size_t rank = 0; rank <= highRank; ++rank)
         {
-            deviations.push_back(std::abs(value - median));
+            const bool takeLeft = right >= size ||
+                                  (left > 0 && median - values[left - 1] <= values[right] - median);
+            if (takeLeft)
+            {
+                current = median - values[left - 1];
+                --left;
+            }
+            else
+            {
+                current = values[right] - median;
+                ++right;
+            }
+            if (rank == lowRank)
+                lowValue = current;
         }
 
-        return getMedian(deviations);
+        return lowValue + (current - lowValue) / 2.0;
     }
 
-    double robustStandardDeviation(const std::vector<double> &values)
+    double medianAbsoluteDeviation(const std::vector<double> &values)
     {
-        const double mad = medianAbsoluteDeviation(values);
+        std::vector<double> work = finiteCopy(values);
+        if (work.empty())
+            return std::numeric_limits<double>::quiet_NaN();
+
+        // Медиана и медиана отклонений — два выбора за O(n) в одном буфере
+        const std::size_t size = work.size();
+        const std::size_t lowRank = (size - 1) / 2;
+        const std::size_t highRank = size / 2;
+
+        selectRanks(work, {lowRank, highRank});
+        const double median = interpolateQuantile(work[lowRank], work[highRank], 0.5);
+        if (std::isnan(median))
+            return std::numeric_limits<double>::quiet_NaN();
+
+        for (double &value : work)
+            value = std::abs(value - median);
+
+        selectRanks(work, {lowRank, highRank});
+        return interpolateQuantile(work[lowRank], work[highRank], 0.5);
+    }
+
+    double robustStandardDeviation(const SortedSample &sorted)
+    {
+        const double mad = medianAbsoluteDeviation(sorted);
         return (mad != 0.0 && !std::isnan(mad)) ? 1.4826 * mad
                                                 : std::numeric_limits<double>::quiet_NaN();
     }
 
-    double modalFrequency(const std::vector<QString> &categories)
+    double robustStandardDeviation(const std::vector<double> &values)
     {
-        if (categories.empty())
-            return std::numeric_limits<double>::quiet_NaN();
+        return robustStandardDeviation(SortedSample(values));
+    }
 
-        std::map<QString, int> freqMap;
-        for (const auto &cat : categories)
-            freqMap[cat]++;
+    double modalFrequency(const FrequencyTable &frequencies)
+    {
+        if (frequencies.total == 0)
+            return std::numeric_limits<double>::quiet_NaN();
 
-        int maxFreq = 0;
-        for (const auto &pair : freqMap)
-        {
-            if (pair.second > maxFreq)
-                maxFreq = pair.second;
-        }
+        return static_cast<double>(frequencies.maxFrequency()) / frequencies.total;
+    }
 
-        return static_cast<double>(maxFreq) / categories.size();
+    double modalFrequency(const std::vector<QString> &categories)
+    {
+        return modalFrequency(FrequencyTable(categories));
     }
 
-    double simpsonDiversityIndex(const std::vector<QString> &categories)
+    double simpsonDiversityIndex(const FrequencyTable &frequencies)
     {
-        if (categories.empty())
+        if (frequencies.total == 0)
             return std::numeric_limits<double>::quiet_NaN();
 
-        std::map<QString, int> freqMap;
-        for (const auto &cat : categories)
-            freqMap[cat]++;
-
         double sum = 0.0;
-        const double total = categories.size();
-        for (const auto &pair : freqMap)
+        const double total = frequencies.total;
+        for (std::size_t count : frequencies.counts)
         {
-            const double p = static_cast<double>(pair.second) / total;
+            const double p = static_cast<double>(count) / total;
             sum += p * p;
         }
 
         return 1.0 - sum;
     }
 
-    double uniqueValueRatio(const std::vector<QString> &categories)
+    double simpsonDiversityIndex(const std::vector<QString> &categories)
     {
-        if (categories.empty())
-            return std::numeric_limits<double>::quiet_NaN();
-        std::unordered_set<QString> unique(categories.begin(), categories.end());
-        return static_cast<double>(unique.size()) / categories.size();
+        return simpsonDiversityIndex(FrequencyTable(categories));
     }
 
-    double entropy(const std::vector<QString> &categories)
+    double uniqueValueRatio(const FrequencyTable &frequencies)
     {
-        if (categories.empty())
+        if (frequencies.total == 0)
             return std::numeric_limits<double>::quiet_NaN();
+        return static_cast<double>(frequencies.distinct()) / frequencies.total;
+    }
 
-        std::map<QString, int> freqMap;
-        for (const auto &cat : categories)
-        {
-            freqMap[cat]++;
-        }
+    double uniqueValueRatio(const std::vector<QString> &categories)
+    {
+        return uniqueValueRatio(FrequencyTable(categories));
+    }
+
+    double entropy(const FrequencyTable &frequencies)
+    {
+        if (frequencies.total == 0)
+            return std::numeric_limits<double>::quiet_NaN();
 
         double entropy = 0.0;
-        const double total = categories.size();
-        for (const auto &pair : freqMap)
+        const double total = frequencies.total;
+        for (std::size_t count : frequencies.counts)
         {
-            const double p = static_cast<double>(pair.second) / total;
+            const double p = static_cast<double>(count) / total;
             if (p > 0)
                 entropy += -p * std::log2(p);
         }
@@ -498,153 +827,342 @@ namespace Calculate
         return entropy;
     }
 
-    double normal_quantile(double p) {
-        if (p <= 0 || p >= 1)
-            return std::numeric_limits<double>::quiet_NaN();
-        double t = std::sqrt(-2.0 * std::log(std::min(p, 1-p)));
-        double x = t - (a[0] + t*(a[1] + t*(a[2] + t*(a[3] + t*(a[4] + t*a[5])))) /
-                        (1.0 + t*(b[0] + t*(b[1] + t*(b[2] + t*(b[3] + t*b[4]))))));
+    double entropy(const std::vector<QString> &categories)
+    {
+        return entropy(FrequencyTable(categories));
+    }
 
-        return (p < 0.5) ? -x : x;
+    double normal_quantile(double p) {
+        Kernels::normalQuantile(&p, &p, 1);
+        return p;
     }
 
-    const std::vector<double>& getShapiroWilkCoefficients(int n) {
-        static std::map<int, std::vector<double>> coefficient_cache;
+    double normal_cdf(double z) {
+        Kernels::normalCdf(&z, &z, 1);
+        return z;
+    }
 
-        if (n < MIN_SAMPLE_SIZE || n > MAX_SAMPLE_SIZE)
-            throw std::invalid_argument("Invalid sample size");
+    // Равномерная подвыборка без возвращения с сохранением порядка (алгоритм S Кнута).
+    // Генератор с фиксированным зерном: для одних и тех же данных результат одинаков.
+    std::vector<double> orderedSubsample(const std::vector<double> &sorted, std::size_t size)
+    {
+        std::mt19937_64 generator(SW_SUBSAMPLE_SEED);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        std::vector<double> sample;
+        sample.reserve(size);
+        std::size_t remaining = sorted.size();
+        for (double value : sorted) {
+            if (uniform(generator) * remaining < size - sample.size())
+                sample.push_back(value);
+            if (sample.size() == size)
+                break;
+            remaining--;
+        }
+        return sample;
+    }
 
-        // Проверяем кэш
-        auto it = coefficient_cache.find(n);
-        if (it != coefficient_cache.end()) {
-            return it->second;
+    // Коэффициенты W по приближению Ройстона (AS R94): вместо обращения ковариационной
+    // матрицы — нормальные метки и полиномиальная поправка двух крайних весов.
+    // Считаются на лету, поэтому кэш и общее состояние между потоками не нужны.
+    std::vector<double> shapiroWilkCoefficients(int n)
+    {
+        std::vector<double> a(n / 2);
+        if (n == 3) {
+            a[0] = M_SQRT1_2;
+            return a;
         }
 
-        // Создаем новый вектор и работаем с ним
-        std::vector<double> a(n/2);
-        for (int i = 0; i < n/2; ++i) {
-            double u = (i + 1 - 0.375) / (n + 0.25);
-            a[i] = normal_quantile(u);
+        // Метки верхней половины: -Φ⁻¹ от вероятностей нижней, одним пакетом
+        std::vector<double> m(n / 2);
+        for (int i = 0; i < n / 2; ++i)
+            m[i] = (i + 1 - 0.375) / (n + 0.25);
+        Kernels::normalQuantile(m.data(), m.data(), m.size());
+        double ssq = 0.0;
+        for (double &value : m) {
+            value = -value;
+            ssq += value * value;
+        }
+        ssq *= 2;
+
+        const double rsn = 1.0 / std::sqrt(static_cast<double>(n));
+        const double norm = std::sqrt(ssq);
+        const double a1 = m[0] / norm + rsn * (0.221157 + rsn * (-0.147981 + rsn * (-2.071190 + rsn * (4.434685 + rsn * -2.706056))));
+
+        int first = 1;
+        double phi;
+        if (n > 5) {
+            first = 2;
+            const double a2 = m[1] / norm + rsn * (0.042981 + rsn * (-0.293762 + rsn * (-1.752461 + rsn * (5.682633 + rsn * -3.582633))));
+            phi = (ssq - 2 * m[0] * m[0] - 2 * m[1] * m[1]) / (1 - 2 * a1 * a1 - 2 * a2 * a2);
+            a[1] = a2;
+        } else {
+            phi = (ssq - 2 * m[0] * m[0]) / (1 - 2 * a1 * a1);
         }
+        a[0] = a1;
 
-        // Нормализация
-        double sum_sq = 0.0;
-        for (double val : a) sum_sq += val * val;
-        double scale = 1.0 / std::sqrt(2 * sum_sq);
-        for (double& val : a) val *= scale;
+        const double scale = 1.0 / std::sqrt(phi);
+        for (int i = first; i < n / 2; ++i)
+            a[i] = m[i] * scale;
+        return a;
+    }
 
-        // Сохраняем в кэш и возвращаем ссылку
-        coefficient_cache[n] = std::move(a);  // Используем перемещение
-        return coefficient_cache.at(n);       // Возвращаем из кэша
+    // p-значение W по нормализующим преобразованиям Ройстона (1992, 1995)
+    double shapiroWilkPValue(double w, int n)
+    {
+        if (n == 3) {
+            const double p = 6.0 / M_PI * (std::asin(std::sqrt(w)) - std::asin(std::sqrt(0.75)));
+            return std::clamp(p, 0.0, 1.0);
+        }
+        if (w >= 1.0)
+            return 1.0;
+
+        double y, mu, sigma;
+        if (n <= 11) {
+            const double gamma = -2.273 + 0.459 * n;
+            const double t = std::log(1.0 - w);
+            if (t >= gamma)
+                return 0.0; // За пределами области преобразования: W исчезающе мало
+            y = -std::log(gamma - t);
+            mu = 0.5440 + n * (-0.39978 + n * (0.025054 + n * -0.0006714));
+            sigma = std::exp(1.3822 + n * (-0.77857 + n * (0.062767 + n * -0.0020322)));
+        } else {
+            const double ln = std::log(static_cast<double>(n));
+            y = std::log(1.0 - w);
+            mu = -1.5861 + ln * (-0.31082 + ln * (-0.083751 + ln * 0.0038915));
+            sigma = std::exp(-0.4803 + ln * (-0.082676 + ln * 0.0030302));
+        }
+        return 1.0 - normal_cdf((y - mu) / sigma);
     }
 
-    double shapiroWilkTest(const std::vector<double> &data)
+    ShapiroWilkResult shapiroWilk(const SortedSample &sorted, const MomentAccumulator &moments)
     {
-        const int n = data.size();
-        if (n < MIN_SAMPLE_SIZE || n > MAX_SAMPLE_SIZE)
-            return std::numeric_limits<double>::quiet_NaN();
+        ShapiroWilkResult result;
+        if (sorted.size() < static_cast<std::size_t>(MIN_SAMPLE_SIZE))
+            return result;
+
+        // Приближение Ройстона проверено до n = 5000; длинные ряды проверяются
+        // по детерминированной подвыборке того же размера
+        std::vector<double> subsample;
+        const std::vector<double> *values = &sorted.values;
+        double ssq = moments.m2;
+        if (sorted.size() > static_cast<std::size_t>(MAX_SAMPLE_SIZE)) {
+            subsample = orderedSubsample(sorted.values, MAX_SAMPLE_SIZE);
+            values = &subsample;
+            ssq = MomentAccumulator(subsample).m2;
+        }
 
-        // 1. Получаем коэффициенты Шапиро-Уилка для данного n
-        const std::vector<double>& a = getShapiroWilkCoefficients(n);
-        if (a.empty() || a.size() != n/2)
-            return std::numeric_limits<double>::quiet_NaN();
+        const int n = values->size();
+        if (values->back() == values->front()) {
+            result.w = 1.0; // Все значения одинаковые
+            result.pValue = 1.0;
+            return result;
+        }
 
-        // 2. Сортируем выборку
-        std::vector<double> sorted = data;
-        std::sort(sorted.begin(), sorted.end());
+        const std::vector<double> a = shapiroWilkCoefficients(n);
+        double numerator = 0.0;
+        for (int i = 0; i < n / 2; ++i)
+            numerator += a[i] * ((*values)[n - 1 - i] - (*values)[i]);
 
-        // 3. Вычисляем сумму квадратов отклонений
-        const double mean = getMean(sorted);
-        double ssq = std::accumulate(sorted.begin(), sorted.end(), 0.0,
-                                     [mean](double acc, double x) { return acc + (x - mean)*(x - mean); });
+        result.w = std::min(1.0, numerator * numerator / ssq);
+        result.pValue = shapiroWilkPValue(result.w, n);
+        return result;
+    }
 
-        if (ssq < std::numeric_limits<double>::epsilon())
-            return 1.0; // Все значения одинаковые
+    double shapiroWilkTest(const SortedSample &sorted, const MomentAccumulator &moments)
+    {
+        return shapiroWilk(sorted, moments).pValue;
+    }
 
-        // 4. Вычисляем числитель W-статистики
-        double numerator = 0.0;
-        for (size_t i = 0; i < a.size(); ++i) {
-            const int j = n - 1 - i;
-            numerator += a[i] * (sorted[j] - sorted[i]);
-        }
-        numerator *= numerator;
+    double shapiroWilkTest(const std::vector<double> &data)
+    {
+        return shapiroWilkTest(SortedSample(data), MomentAccumulator(data));
+    }
+
+    double kdeBandwidth(const MomentAccumulator &moments, double iqr, BandwidthRule rule)
+    {
+        const double sigma = getStandardDeviation(moments);
+        if (!std::isfinite(sigma))
+            return std::numeric_limits<double>::quiet_NaN();
 
-        // 5. Рассчитываем W-статистику
-        const double W = numerator / ssq;
+        const double scale = std::pow(static_cast<double>(moments.count), -0.2);
+        if (rule == BandwidthRule::Scott)
+            return 1.06 * sigma * scale;
 
-        // 6. Сравнение с критическим значением
-        return (W >= SW_CRITICAL_VALUE) ? 1.0 : 0.0;
+        // Правило Сильвермана: устойчивый разброс, если межквартильный размах не вырожден
+        const double spread = (iqr > 0.0) ? std::min(sigma, iqr / 1.34) : sigma;
+        return 0.9 * spread * scale;
     }
 
-    double calculateDensity(const std::vector<double> &data, double point)
+    double kdeBandwidth(const std::vector<double> &data, BandwidthRule rule)
     {
-        if (data.empty() || KDE_BANDWIDTH < KDE_EPSILON)
+        const std::vector<double> q = quantiles(data, {0.25, 0.75});
+        return kdeBandwidth(MomentAccumulator(data), q[1] - q[0], rule);
+    }
+
+    double calculateDensity(const std::vector<double> &data, double point, double bandwidth)
+    {
+        if (data.empty() || !(bandwidth >= KDE_EPSILON))
             return std::numeric_limits<double>::quiet_NaN();
 
-        const double h = KDE_BANDWIDTH;
+        const double h = bandwidth;
         double sum = 0.0;
+        std::size_t n = 0;
 
         for (double xi : data)
         {
+            if (!std::isfinite(xi))
+                continue;
             const double u = (point - xi) / h;
             sum += exp(-0.5 * u * u) / sqrt(2 * M_PI);
+            n++;
         }
 
-        return sum / (data.size() * h);
+        return n ? sum / (n * h) : std::numeric_limits<double>::quiet_NaN();
     }
 
-    // Реализация обратной функции ошибок через метод Ньютона
-    double erf_inv(double y) {
-        if (y <= -1.0 || y >= 1.0) {
-            return std::copysign(std::numeric_limits<double>::infinity(), y);
+    double calculateDensity(const std::vector<double> &data, double point)
+    {
+        return calculateDensity(data, point, kdeBandwidth(data));
+    }
+
+    // Итеративное БПФ по основанию 2 на месте; размер — степень двойки
+    void fft(std::vector<std::complex<double>> &a, bool inverse)
+    {
+        const std::size_t n = a.size();
+        for (std::size_t i = 1, j = 0; i < n; ++i)
+        {
+            std::size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(a[i], a[j]);
         }
-        constexpr double twoOverSqrtPi = 1.1283791670955126;
-        constexpr double eps = 1e-12;
-        constexpr int max_iter = 50;
-        double x = 0.0;
 
-        // Начальное приближение
-        if (y < -0.7) x = -std::sqrt(-std::log((1.0 + y)/2.0));
-        else if (y > 0.7) x = std::sqrt(-std::log((1.0 - y)/2.0));
-        else x = y * M_PI_2;
+        for (std::size_t len = 2; len <= n; len <<= 1)
+        {
+            const double angle = 2 * M_PI / len * (inverse ? 1 : -1);
+            const std::complex<double> step(std::cos(angle), std::sin(angle));
+            for (std::size_t i = 0; i < n; i += len)
+            {
+                std::complex<double> w(1.0);
+                for (std::size_t k = 0; k < len / 2; ++k)
+                {
+                    const std::complex<double> u = a[i + k];
+                    const std::complex<double> v = a[i + k + len / 2] * w;
+                    a[i + k] = u + v;
+                    a[i + k + len / 2] = u - v;
+                    w *= step;
+                }
+            }
+        }
 
-        // Уточнение методом Ньютона
-        for (int i = 0; i < max_iter; ++i) {
-            double err = std::erf(x) - y;
-            if (std::abs(err) < eps) break;
+        if (inverse)
+            for (auto &x : a)
+                x /= static_cast<double>(n);
+    }
 
-            // Производная: d/dx erf(x) = 2/sqrt(π) * exp(-x²)
-            x -= err / (twoOverSqrtPi * std::exp(-x*x));
+    DensityCurve densityCurve(const std::vector<double> &data, const MomentAccumulator &moments,
+                              double bandwidth, std::size_t gridSize)
+    {
+        DensityCurve curve;
+        curve.bandwidth = bandwidth;
+        if (moments.count < 2 || gridSize < 2 || !(bandwidth >= KDE_EPSILON))
+            return curve;
+
+        // Сетка с запасом в 3h по краям, чтобы хвосты ядра не обрезались
+        const std::size_t m = gridSize;
+        const double lo = moments.min - 3 * bandwidth;
+        const double hi = moments.max + 3 * bandwidth;
+        const double delta = (hi - lo) / (m - 1);
+
+        // 1. Линейное распределение каждой точки между двумя соседними узлами
+        std::vector<double> counts(m, 0.0);
+        for (double x : data)
+        {
+            if (!std::isfinite(x))
+                continue;
+            const double pos = (x - lo) / delta;
+            const std::size_t j = std::min(static_cast<std::size_t>(pos), m - 2);
+            const double w = pos - j;
+            counts[j] += 1.0 - w;
+            counts[j + 1] += w;
         }
-        return x;
+
+        // 2. Ядро в узлах сетки до 4h; дальше его вклад пренебрежимо мал
+        const std::size_t reach = std::min<std::size_t>(m - 1, static_cast<std::size_t>(std::ceil(4 * bandwidth / delta)));
+        std::size_t size = 1;
+        while (size < m + reach + 1)
+            size <<= 1;
+
+        std::vector<std::complex<double>> signal(size), kernel(size);
+        for (std::size_t j = 0; j < m; ++j)
+            signal[j] = counts[j];
+
+        const double norm = 1.0 / (std::sqrt(2 * M_PI) * bandwidth * moments.count);
+        for (std::size_t k = 0; k <= reach; ++k)
+        {
+            const double u = k * delta / bandwidth;
+            const double weight = std::exp(-0.5 * u * u) * norm;
+            kernel[k] = weight;
+            if (k > 0)
+                kernel[size - k] = weight; // Отрицательные сдвиги — в конце циклического буфера
+        }
+
+        // 3. Свёртка через произведение спектров
+        fft(signal, false);
+        fft(kernel, false);
+        for (std::size_t i = 0; i < size; ++i)
+            signal[i] *= kernel[i];
+        fft(signal, true);
+
+        curve.grid.resize(m);
+        curve.density.resize(m);
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            curve.grid[j] = lo + j * delta;
+            curve.density[j] = std::max(0.0, signal[j].real()); // Убираем шум округления БПФ
+        }
+        return curve;
     }
 
+    DensityCurve densityCurve(const std::vector<double> &data, std::size_t gridSize, BandwidthRule rule)
+    {
+        const MomentAccumulator moments(data);
+        const std::vector<double> q = quantiles(data, {0.25, 0.75});
+        return densityCurve(data, moments, kdeBandwidth(moments, q[1] - q[0], rule), gridSize);
+    }
 
     double chiSquareTest(const std::vector<double> &data) {
+        if (data.size() < MIN_SAMPLE_SIZE)
+            return std::numeric_limits<double>::quiet_NaN();
+        return chiSquareTest(data, MomentAccumulator(data));
+    }
+
+    double chiSquareTest(const std::vector<double> &data, const MomentAccumulator &moments) {
         if (data.size() < MIN_SAMPLE_SIZE)
             return std::numeric_limits<double>::quiet_NaN();
 
         // 1. Оценка параметров распределения
-        const double mu = getMean(data);
-        const double sigma = getStandardDeviation(data, mu);
+        const double mu = getMean(moments);
+        const double sigma = getStandardDeviation(moments);
 
         // Проверка edge-case: все данные одинаковые
         if (sigma < std::numeric_limits<double>::epsilon()) {
             return std::numeric_limits<double>::quiet_NaN();
         }
 
-        // 2. Создание бинов через квантили
+        // 2. Создание равновероятных бинов через квантили нормального распределения
         const int target_bins = CHI2_BINS;
         std::vector<double> bin_edges(target_bins + 1);
-
-        try {
-            for (int i = 0; i <= target_bins; ++i) {
-                const double p = static_cast<double>(i)/target_bins;
-                bin_edges[i] = mu + sigma * std::sqrt(2.0) * erf_inv(2*p - 1);
-            }
-        } catch (...) {
-            return std::numeric_limits<double>::quiet_NaN();
-        }
+        for (int i = 0; i <= target_bins; ++i)
+            bin_edges[i] = static_cast<double>(i) / target_bins;
+        Kernels::normalQuantile(bin_edges.data() + 1, bin_edges.data() + 1, target_bins - 1);
+        bin_edges.front() = -std::numeric_limits<double>::infinity();
+        bin_edges.back() = std::numeric_limits<double>::infinity();
+        for (int i = 1; i < target_bins; ++i)
+            bin_edges[i] = mu + sigma * bin_edges[i];
 
         // 3. Подсчет наблюдаемых частот
         std::vector<int> observed(target_bins, 0);
@@ -655,14 +1173,9 @@ namespace Calculate
             observed[bin]++;
         }
 
-        // 4. Расчет ожидаемых частот
-        std::vector<double> expected(target_bins);
+        // 4. Ожидаемые частоты: бины равновероятны по построению
         const double total = data.size();
-        for (int i = 0; i < target_bins; ++i) {
-            double p_low = 0.5 * (1 + std::erf((bin_edges[i] - mu)/(sigma * M_SQRT2)));
-            double p_high = 0.5 * (1 + std::erf((bin_edges[i+1] - mu)/(sigma * M_SQRT2)));
-            expected[i] = total * (p_high - p_low);
-        }
+        const std::vector<double> expected(target_bins, total / target_bins);
 
         // 5. Объединение бинов с малыми ожиданиями
         std::vector<int> obs_merged;
@@ -696,61 +1209,48 @@ namespace Calculate
         return chi2;
     }
 
-    double calculateMean(const std::vector<double>& data) {
-        return std::accumulate(data.begin(), data.end(), 0.0) / data.size();
-    }
-
-    double calculateStdDev(const std::vector<double>& data) {
-        const double mean = calculateMean(data);
-        double sq_sum = 0.0;
-        for (double v : data) {
-            sq_sum += (v - mean) * (v - mean);
-        }
-        return std::sqrt(sq_sum / (data.size() - 1));  // Несмещенная оценка
-    }
-
-    double kolmogorovSmirnovTest(const std::vector<double> &data) {
+    double kolmogorovSmirnovTest(const SortedSample &sorted, const MomentAccumulator &moments) {
         const int MIN_SAMPLE_SIZE = 30;  // Минимальный размер выборки
 
-        if (data.size() < MIN_SAMPLE_SIZE)
+        if (sorted.size() < MIN_SAMPLE_SIZE)
             return std::numeric_limits<double>::quiet_NaN();
 
-        // 1. Рассчитываем параметры распределения
-        const double mu = calculateMean(data);
-        const double sigma = calculateStdDev(data);
+        // 1. Параметры распределения берём из накопителя моментов
+        const double mu = getMean(moments);
+        const double sigma = getStandardDeviation(moments);
 
         // Проверка edge case: нулевое стандартное отклонение
-        if (sigma < std::numeric_limits<double>::epsilon()) {
+        if (std::isnan(sigma) || sigma < std::numeric_limits<double>::epsilon()) {
             return std::numeric_limits<double>::quiet_NaN();
         }
 
-        // 2. Сортируем данные
-        std::vector<double> sorted = data;
-        std::sort(sorted.begin(), sorted.end());
+        // 2. Данные уже отсортированы снимком
+        const std::vector<double> &values = sorted.values;
 
-        // 3. Вычисляем статистику D
+        // 3. Вычисляем статистику D = max(D+, D-). Теоретическая CDF считается
+        // пакетами векторным ядром, по одному разу на элемент
+        constexpr std::size_t BLOCK = 1024;
+        double F[BLOCK];
         double D = 0.0;
-        const double n = sorted.size();
-        const double sqrt2 = std::sqrt(2.0);
-
-        for (size_t i = 0; i < sorted.size(); ++i) {
-            // Эмпирическая функция распределения
-            const double Fn = (i + 1) / n;  // (i+1) для поправки на непрерывность
-
-            // Теоретическая CDF (нормальное распределение)
-            const double z = (sorted[i] - mu) / sigma;
-            const double F = 0.5 * (1 + std::erf(z / sqrt2));
-
-            // Максимальное расхождение
-            D = std::max(D, std::abs(Fn - F));
-
-            // Проверка для предыдущего значения (требуется для двустороннего сравнения)
-            if (i > 0) {
-                const double F_prev = 0.5 * (1 + std::erf((sorted[i-1] - mu)/sigma / sqrt2));
-                D = std::max(D, std::abs((i/n) - F_prev));
+        const double n = values.size();
+        const double invSigma = 1.0 / sigma;
+
+        for (std::size_t begin = 0; begin < values.size(); begin += BLOCK) {
+            const std::size_t count = std::min(BLOCK, values.size() - begin);
+            for (std::size_t j = 0; j < count; ++j)
+                F[j] = (values[begin + j] - mu) * invSigma;
+            Kernels::normalCdf(F, F, count);
+
+            for (std::size_t j = 0; j < count; ++j) {
+                const double i = static_cast<double>(begin + j);
+                D = std::max(D, std::max((i + 1) / n - F[j], F[j] - i / n));
             }
         }
 
         return D;
     }
+
+    double kolmogorovSmirnovTest(const std::vector<double> &data) {
+        return kolmogorovSmirnovTest(SortedSample(data), MomentAccumulator(data));
+    }
 }
@@ -1,7 +1,6 @@
 #ifndef CALCULATIONS_H
 #define CALCULATIONS_H
 
-#include <QTableWidgetItem>
 #include <QString>
 #include <QHash>
 #include <QSet>
@@ -9,42 +8,153 @@
 
 #include "calculate.h"
 #include "globals.h"
+#include "kernels.h"
 #include "structs.h"
+#include "tableModel.h"
 
 #include <limits>
 #include <cmath>
 #include <algorithm>
 #include <numeric>
-#include <unordered_set>
 #include <map>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <random>
 #include <vector>
 
 namespace Calculate
 {
-    std::vector<double> getWeights(const QTableWidget* table, int weightColumn);
-    std::vector<double> findWeights(const QTableWidget* table); // Автоматический поиск столбца с весами
+    using NeumaierSum = Kernels::NeumaierSum;
+
+    // Однопроходный накопитель моментов (обновление Уэлфорда/Пебэя).
+    // Нечисловые значения (inf, nan) не входят в моменты и учитываются в nonFinite.
+    struct MomentAccumulator
+    {
+        std::size_t count = 0;
+        std::size_t nonFinite = 0;
+        NeumaierSum sum;
+        double min = std::numeric_limits<double>::infinity();
+        double max = -std::numeric_limits<double>::infinity();
+        double mean = 0.0;
+        double m2 = 0.0; // Сумма квадратов отклонений от среднего
+        double m3 = 0.0; // Сумма кубов отклонений
+        double m4 = 0.0; // Сумма четвёртых степеней отклонений
+        NeumaierSum logSum;        // Только пока все значения положительны
+        NeumaierSum reciprocalSum; // Только пока все значения положительны
+
+        MomentAccumulator() = default;
+        explicit MomentAccumulator(const std::vector<double>& values);
+        void add(double value);
+        void add(const double* data, std::size_t size); // Блоками через векторные ядра
+        void merge(const MomentAccumulator& other);
+    };
+
+    // Отсортированный снимок ряда, общий для всех порядковых статистик.
+    // Строится один раз на версию данных; нечисловые значения отбрасываются.
+    struct SortedSample
+    {
+        std::vector<double> values;
+
+        SortedSample() = default;
+        explicit SortedSample(const std::vector<double>& data);
+        std::size_t size() const { return values.size(); }
+        bool empty() const { return values.empty(); }
+    };
+
+    // Таблица частот, общая для моды и категориальных метрик. Строится одним
+    // проходом по хэш-таблице с открытой адресацией; строки интернируются в
+    // номера категорий, частоты хранятся по номеру ключа в порядке появления.
+    struct FrequencyTable
+    {
+        std::vector<double> keys;        // Числовые ключи (только конечные значения)
+        std::vector<QString> categories; // Интернированные категории: номер -> строка
+        std::vector<std::size_t> counts;
+        std::size_t total = 0;
+
+        FrequencyTable() = default;
+        explicit FrequencyTable(const std::vector<double>& values);
+        explicit FrequencyTable(const std::vector<QString>& values);
+        std::size_t distinct() const { return counts.size(); }
+        std::size_t maxFrequency() const;
+    };
+
+    // Правило выбора ширины окна ядерной оценки плотности
+    enum class BandwidthRule { Silverman, Scott };
+
+    // Ядерная оценка плотности на равномерной сетке
+    struct DensityCurve
+    {
+        std::vector<double> grid;
+        std::vector<double> density;
+        double bandwidth = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    // Статистика W и p-значение критерия Шапиро-Уилка
+    struct ShapiroWilkResult
+    {
+        double w = std::numeric_limits<double>::quiet_NaN();
+        double pValue = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    std::vector<double> getWeights(const TableModel* table, int weightColumn);
+    std::vector<double> findWeights(const TableModel* table); // Автоматический поиск столбца с весами
     double getSum(const std::vector<double>& values);
+    double getSum(const MomentAccumulator& moments);
     double getMean(const std::vector<double>& values);
+    double getMean(const MomentAccumulator& moments);
+    // Квантили (интерполяция типа 7) за ожидаемое O(n) многоопорным выбором без сортировки
+    std::vector<double> quantiles(const std::vector<double>& values, const std::vector<double>& probabilities);
+    std::vector<double> quantiles(const SortedSample& sorted, const std::vector<double>& probabilities);
     double getMedian(const std::vector<double>& values);
+    double getMedian(const SortedSample& sorted);
     double getMode(const std::vector<double> &values);
-    double getStandardDeviation(const std::vector<double> &values, double mean);
+    double getMode(const FrequencyTable& frequencies);
+    double getStandardDeviation(const std::vector<double> &values);
+    double getStandardDeviation(const MomentAccumulator& moments);
     double geometricMean(const std::vector<double>& values);
+    double geometricMean(const MomentAccumulator& moments);
     double harmonicMean(const std::vector<double>& values);
+    double harmonicMean(const MomentAccumulator& moments);
     double weightedMean(const std::vector<double>& values, const std::vector<double>& weights);
     double rootMeanSquare(const std::vector<double>& values);
-    double skewness(const std::vector<double>& values, double mean, double stdDev);
-    double kurtosis(const std::vector<double>& values, double mean, double stdDev);
+    double rootMeanSquare(const MomentAccumulator& moments);
+    double skewness(const std::vector<double>& values);
+    double skewness(const MomentAccumulator& moments);
+    double kurtosis(const std::vector<double>& values);
+    double kurtosis(const MomentAccumulator& moments);
     double trimmedMean(const std::vector<double>& values, double trimFraction);
+    double trimmedMean(const SortedSample& sorted, double trimFraction);
     double medianAbsoluteDeviation(const std::vector<double>& values);
+    double medianAbsoluteDeviation(const SortedSample& sorted);
     double robustStandardDeviation(const std::vector<double>& values);
+    double robustStandardDeviation(const SortedSample& sorted);
     double modalFrequency(const std::vector<QString>& categories);
+    double modalFrequency(const FrequencyTable& frequencies);
     double simpsonDiversityIndex(const std::vector<QString>& categories);
+    double simpsonDiversityIndex(const FrequencyTable& frequencies);
     double uniqueValueRatio(const std::vector<QString>& categories);
+    double uniqueValueRatio(const FrequencyTable& frequencies);
     double entropy(const std::vector<QString>& categories);
-    double shapiroWilkTest(const std::vector<double>& data);
-    double calculateDensity(const std::vector<double>& data, double point);
+    double entropy(const FrequencyTable& frequencies);
+    // Любой размер ряда: при n > MAX_SAMPLE_SIZE — детерминированная подвыборка
+    ShapiroWilkResult shapiroWilk(const SortedSample& sorted, const MomentAccumulator& moments);
+    double shapiroWilkTest(const std::vector<double>& data); // p-значение
+    double shapiroWilkTest(const SortedSample& sorted, const MomentAccumulator& moments);
+    double kdeBandwidth(const MomentAccumulator& moments, double iqr, BandwidthRule rule = BandwidthRule::Silverman);
+    double kdeBandwidth(const std::vector<double>& data, BandwidthRule rule = BandwidthRule::Silverman);
+    double calculateDensity(const std::vector<double>& data, double point); // Ширина окна по правилу Сильвермана
+    double calculateDensity(const std::vector<double>& data, double point, double bandwidth);
+    // Гауссово ядро на сетке из gridSize узлов за O(n + M log M): линейное
+    // распределение по узлам и свёртка через БПФ
+    DensityCurve densityCurve(const std::vector<double>& data, const MomentAccumulator& moments,
+                              double bandwidth, std::size_t gridSize = KDE_GRID_SIZE);
+    DensityCurve densityCurve(const std::vector<double>& data, std::size_t gridSize = KDE_GRID_SIZE,
+                              BandwidthRule rule = BandwidthRule::Silverman);
     double chiSquareTest(const std::vector<double>& data);
+    double chiSquareTest(const std::vector<double>& data, const MomentAccumulator& moments);
     double kolmogorovSmirnovTest(const std::vector<double>& data);
+    double kolmogorovSmirnovTest(const SortedSample& sorted, const MomentAccumulator& moments);
 }
 
 #endif // CALCULATIONS_H
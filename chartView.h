@@ -0,0 +1,102 @@
+#ifndef CHARTVIEW_H
+#define CHARTVIEW_H
+
+#include <QChartView>
+#include <QValueAxis>
+#include <QWheelEvent>
+#include <QMouseEvent>
+
+#include "globals.h"
+
+// График с масштабом колесом мыши и перетаскиванием по оси X. Двигается
+// только заданная ось: шкала плотности сверху остаётся на месте, а ось Y
+// подбирается по видимым точкам снаружи
+class ChartView : public QChartView
+{
+    Q_OBJECT
+public:
+    explicit ChartView(QChart* chart, QWidget* parent = nullptr) : QChartView(chart, parent) {}
+
+    void setZoomAxis(QValueAxis* axis) { m_axis = axis; }
+    // Диапазон оси X без масштаба: дальше него колесо не отдаляет
+    void setFullRange(double min, double max) { m_fullMin = min; m_fullMax = max; }
+    bool isZoomed() const { return m_zoomed; }
+
+signals:
+    void viewReset(); // Двойной щелчок: вернуть оси ко всем данным
+
+protected:
+    void wheelEvent(QWheelEvent* event) override {
+        // Горизонтальная прокрутка (тачпад, наклон колеса) масштаб не меняет
+        const QRectF area = chart()->plotArea();
+        if (!m_axis || area.width() <= 0 || event->angleDelta().y() == 0) return QChartView::wheelEvent(event);
+
+        // Точка под курсором остаётся на месте
+        const double factor = event->angleDelta().y() > 0 ? ZOOM_STEP : 1.0 / ZOOM_STEP;
+        const double span = m_axis->max() - m_axis->min();
+        const double ratio = qBound(0.0, (event->position().x() - area.left()) / area.width(), 1.0);
+        const double anchor = m_axis->min() + ratio * span;
+        const double newSpan = qMax(span / factor, 2.0); // Не уже двух столбцов
+
+        // Отдалились до всех данных: оси снова следуют за ними
+        if (factor < 1.0 && newSpan >= m_fullMax - m_fullMin) {
+            m_zoomed = false;
+            emit viewReset();
+            event->accept();
+            return;
+        }
+
+        m_zoomed = true;
+        m_axis->setRange(anchor - ratio * newSpan, anchor + (1.0 - ratio) * newSpan);
+        event->accept();
+    }
+
+    void mousePressEvent(QMouseEvent* event) override {
+        if (m_axis && event->button() == Qt::LeftButton
+            && chart()->plotArea().contains(event->position())) {
+            m_panning = true;
+            m_panOrigin = event->position().x();
+            setCursor(Qt::ClosedHandCursor);
+            event->accept();
+            return;
+        }
+        QChartView::mousePressEvent(event);
+    }
+
+    void mouseMoveEvent(QMouseEvent* event) override {
+        if (!m_panning) return QChartView::mouseMoveEvent(event);
+
+        const double width = chart()->plotArea().width();
+        if (width > 0) {
+            const double shift = (m_panOrigin - event->position().x()) / width * (m_axis->max() - m_axis->min());
+            m_zoomed = true;
+            m_axis->setRange(m_axis->min() + shift, m_axis->max() + shift);
+        }
+        m_panOrigin = event->position().x();
+        event->accept();
+    }
+
+    void mouseReleaseEvent(QMouseEvent* event) override {
+        if (!m_panning) return QChartView::mouseReleaseEvent(event);
+        m_panning = false;
+        unsetCursor();
+        event->accept();
+    }
+
+    void mouseDoubleClickEvent(QMouseEvent* event) override {
+        if (!m_zoomed) return QChartView::mouseDoubleClickEvent(event);
+        m_zoomed = false;
+        emit viewReset();
+        event->accept();
+    }
+
+private:
+    QValueAxis* m_axis = nullptr;
+    double m_fullMin = 0.0;
+    double m_fullMax = 10.0;
+    bool m_zoomed = false;  // Окно оси X задано пользователем и не следует за данными
+    bool m_panning = false;
+    double m_panOrigin = 0.0;
+};
+
+#endif // CHARTVIEW_H
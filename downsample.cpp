@@ -0,0 +1,191 @@
+#include "downsample.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Downsample
+{
+    std::pair<std::size_t, std::size_t> visibleRange(const SeriesData& data, double xMin, double xMax)
+    {
+        const auto begin = data.x.begin();
+        std::size_t first = std::lower_bound(begin, data.x.end(), xMin) - begin;
+        std::size_t last = std::upper_bound(begin, data.x.end(), xMax) - begin;
+
+        if (first > 0) first--;
+        if (last < data.size()) last++;
+        return {first, std::max(first, last)};
+    }
+
+    QList<QPointF> all(const SeriesData& data, std::size_t first, std::size_t last)
+    {
+        QList<QPointF> points;
+        points.reserve(last - first);
+        for (std::size_t i = first; i < last; ++i)
+            points.append(QPointF(data.x[i], data.values[i]));
+        return points;
+    }
+
+    // Индексы точек огибающей: минимум и максимум на столбец пикселей в порядке
+    // следования, крайние точки окна и соседи за его краями как есть
+    std::vector<std::size_t> minMaxIndices(const SeriesData& data, const Pyramid& pyramid,
+                                           std::size_t first, std::size_t last,
+                                           double xMin, double xMax, int columns)
+    {
+        std::vector<std::size_t> indices;
+        indices.reserve(2 * columns + 4);
+
+        const int* x = data.x.data();
+
+        std::size_t i = first;
+        for (; i < last && x[i] < xMin; ++i)
+            indices.push_back(i);
+        const std::size_t visibleBegin = i;
+        const std::size_t visibleEnd = std::upper_bound(x + i, x + last, xMax) - x;
+
+        // Столбцы пикселей идут по возрастанию X, поэтому точки столбца — отрезок
+        // массива: границы находятся двоичным поиском, экстремумы — запросом к пирамиде
+        const double step = (xMax - xMin) / columns;
+        for (int column = 0; column < columns && i < visibleEnd; ++column) {
+            const std::size_t end = column + 1 == columns
+                ? visibleEnd
+                : std::lower_bound(x + i, x + visibleEnd, xMin + (column + 1) * step) - x;
+            if (end == i)
+                continue;
+
+            const RangeStats range = pyramid.query(data, i, end);
+            const std::size_t lo = range.argMin;
+            const std::size_t hi = range.argMax;
+
+            if (i == visibleBegin && std::min(lo, hi) != i)
+                indices.push_back(i);
+            indices.push_back(std::min(lo, hi));
+            if (hi != lo)
+                indices.push_back(std::max(lo, hi));
+            if (end == visibleEnd && std::max(lo, hi) != end - 1)
+                indices.push_back(end - 1);
+            i = end;
+        }
+
+        for (i = visibleEnd; i < last; ++i)
+            indices.push_back(i);
+        return indices;
+    }
+
+    QList<QPointF> minMax(const SeriesData& data, const Pyramid& pyramid, std::size_t first, std::size_t last,
+                          double xMin, double xMax, int columns)
+    {
+        const std::size_t count = last - first;
+        if (columns <= 0 || xMax <= xMin || count <= 2 * static_cast<std::size_t>(columns))
+            return all(data, first, last);
+
+        QList<QPointF> points;
+        const std::vector<std::size_t> indices = minMaxIndices(data, pyramid, first, last, xMin, xMax, columns);
+        points.reserve(indices.size());
+        for (std::size_t i : indices)
+            points.append(QPointF(data.x[i], data.values[i]));
+        return points;
+    }
+
+    // Крайние точки сохраняются, середина делится на threshold - 2 корзины.
+    // Из каждой корзины берётся точка, образующая наибольший треугольник
+    // с уже выбранной точкой и средним следующей корзины
+    QList<QPointF> lttb(const SeriesData& data, const std::vector<std::size_t>& indices, std::size_t threshold)
+    {
+        const std::size_t count = indices.size();
+        QList<QPointF> points;
+        points.reserve(std::min(count, threshold));
+
+        auto x = [&](std::size_t k) { return static_cast<double>(data.x[indices[k]]); };
+        auto y = [&](std::size_t k) { return data.values[indices[k]]; };
+        if (threshold < 3 || count <= threshold) {
+            for (std::size_t k = 0; k < count; ++k)
+                points.append(QPointF(x(k), y(k)));
+            return points;
+        }
+
+        const double bucketSize = static_cast<double>(count - 2) / (threshold - 2);
+        auto bucketStart = [&](std::size_t bucket) {
+            return std::min(count - 1, 1 + static_cast<std::size_t>(bucket * bucketSize));
+        };
+
+        std::size_t selected = 0;
+        points.append(QPointF(x(0), y(0)));
+
+        for (std::size_t bucket = 0; bucket < threshold - 2; ++bucket) {
+            const std::size_t begin = bucketStart(bucket);
+            const std::size_t end = bucketStart(bucket + 1);
+
+            // Среднее следующей корзины; у последней — крайняя точка
+            double avgX = x(count - 1), avgY = y(count - 1);
+            const std::size_t nextEnd = bucketStart(bucket + 2);
+            if (bucket + 3 < threshold && nextEnd > end) {
+                avgX = avgY = 0.0;
+                for (std::size_t k = end; k < nextEnd; ++k) {
+                    avgX += x(k);
+                    avgY += y(k);
+                }
+                avgX /= nextEnd - end;
+                avgY /= nextEnd - end;
+            }
+
+            // Удвоенная площадь треугольника линейна по точке корзины:
+            // |dy·(x - ax) - dx·(y - ay)|, где (dx, dy) — от выбранной точки к среднему
+            const double ax = x(selected), ay = y(selected);
+            const double dx = avgX - ax, dy = avgY - ay;
+            double maxArea = -1.0;
+            std::size_t best = begin;
+            for (std::size_t k = begin; k < end; ++k) {
+                const double area = std::abs(dy * (x(k) - ax) - dx * (y(k) - ay));
+                if (area > maxArea) {
+                    maxArea = area;
+                    best = k;
+                }
+            }
+
+            selected = best;
+            points.append(QPointF(x(best), y(best)));
+        }
+
+        points.append(QPointF(x(count - 1), y(count - 1)));
+        return points;
+    }
+
+    QList<QPointF> lttb(const SeriesData& data, const Pyramid& pyramid,
+                        std::size_t first, std::size_t last, std::size_t threshold)
+    {
+        const std::size_t count = last - first;
+        if (threshold < 3 || count <= threshold)
+            return all(data, first, last);
+
+        // Длинный отрезок сначала сводится к огибающей мин/макс (MinMaxLTTB):
+        // выбросы в неё попадают гарантированно, а треугольники считаются
+        // только по LTTB_PRESELECT_RATIO * threshold точкам
+        std::vector<std::size_t> indices;
+        if (count > LTTB_PRESELECT_RATIO * threshold) {
+            const int columns = static_cast<int>(LTTB_PRESELECT_RATIO * threshold / 2);
+            indices = minMaxIndices(data, pyramid, first, last, data.x[first], data.x[last - 1], columns);
+        } else {
+            indices.resize(count);
+            std::iota(indices.begin(), indices.end(), first);
+        }
+        return lttb(data, indices, threshold);
+    }
+
+    QList<QPointF> visiblePoints(const SeriesData& data, const Pyramid& pyramid,
+                                 double xMin, double xMax, int pixelWidth, Mode mode)
+    {
+        const auto [first, last] = visibleRange(data, xMin, xMax);
+        const int columns = std::max(1, pixelWidth);
+
+        switch (mode) {
+        case Mode::Lttb:
+            return lttb(data, pyramid, first, last, LOD_POINTS_PER_PIXEL * static_cast<std::size_t>(columns));
+        case Mode::MinMax:
+            return minMax(data, pyramid, first, last, xMin, xMax, columns);
+        case Mode::All:
+            break;
+        }
+        return all(data, first, last);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef DOWNSAMPLE_H
+#define DOWNSAMPLE_H
+
+#include <QList>
+#include <QPointF>
+
+#include "globals.h"
+#include "structs.h"
+#include "pyramid.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Прореживание рядов перед выводом на график: на экран уходит не больше
+// двух точек на пиксель ширины области построения
+namespace Downsample
+{
+    enum class Mode {
+        All,    // Без прореживания
+        Lttb,   // Largest-Triangle-Three-Buckets: сохраняет форму линии
+        MinMax, // Минимум и максимум на столбец пикселей: сохраняет выбросы
+    };
+
+    // Индексы [first, last) точек в окне [xMin, xMax] и по одному соседу снаружи,
+    // чтобы линия доходила до края области. Столбцы ряда идут по возрастанию
+    std::pair<std::size_t, std::size_t> visibleRange(const SeriesData& data, double xMin, double xMax);
+
+    QList<QPointF> all(const SeriesData& data, std::size_t first, std::size_t last);
+    // Экстремумы столбцов берутся из пирамиды ряда: O(columns · log n) вместо прохода по отрезку
+    QList<QPointF> lttb(const SeriesData& data, const Pyramid& pyramid,
+                        std::size_t first, std::size_t last, std::size_t threshold);
+    QList<QPointF> minMax(const SeriesData& data, const Pyramid& pyramid, std::size_t first, std::size_t last,
+                          double xMin, double xMax, int columns);
+
+    // Индексы огибающей мин/макс и LTTB над произвольным набором индексов ряда
+    std::vector<std::size_t> minMaxIndices(const SeriesData& data, const Pyramid& pyramid,
+                                           std::size_t first, std::size_t last,
+                                           double xMin, double xMax, int columns);
+    QList<QPointF> lttb(const SeriesData& data, const std::vector<std::size_t>& indices, std::size_t threshold);
+
+    // Видимая часть ряда для области шириной pixelWidth пикселей
+    QList<QPointF> visiblePoints(const SeriesData& data, const Pyramid& pyramid,
+                                 double xMin, double xMax, int pixelWidth, Mode mode);
+}
+
+#endif // DOWNSAMPLE_H
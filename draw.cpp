@@ -51,9 +51,9 @@ namespace Draw {
         return marker;
     }
 
-    QTableWidget *setupTable(QWidget *parent) {
+    DataTable *setupTable(QWidget *parent) {
         // Правая часть - таблица
-        QTableWidget *table = new QTableWidget(initialRowCount, initialColCount, parent);
+        DataTable *table = new DataTable(initialRowCount, initialColCount, parent);
         Draw::setSizePolicyExpanding(table);
         table->setItemDelegate(new NumericDelegate(table));
         table->verticalHeader()->setVisible(false);
@@ -180,7 +180,7 @@ namespace Draw {
         }
     }
 
-    QGroupBox* createChartSettingsPanel(QWidget* parent, QLineEdit** xAxisEdit, QLineEdit** yAxisEdit) {
+    QGroupBox* createChartSettingsPanel(QWidget* parent, QLineEdit** xAxisEdit, QLineEdit** yAxisEdit, QComboBox** detailCombo) {
         QGroupBox* settingsGroup = new QGroupBox("Настройки визуализации", parent);
         QFormLayout* formLayout = new QFormLayout(settingsGroup);
 
@@ -196,9 +196,18 @@ namespace Draw {
         yEdit->setPlaceholderText("Введите название вертикальной оси");
         formLayout->addRow("Ось Y:", yEdit);
 
+        // Прореживание рядов: на график уходит не больше двух точек на пиксель
+        QComboBox* detail = new QComboBox(settingsGroup);
+        detail->addItem("Все точки", static_cast<int>(Downsample::Mode::All));
+        detail->addItem("Форма линии (LTTB)", static_cast<int>(Downsample::Mode::Lttb));
+        detail->addItem("Мин/макс на пиксель", static_cast<int>(Downsample::Mode::MinMax));
+        detail->setCurrentIndex(1);
+        formLayout->addRow("Детализация:", detail);
+
         // Возвращаем указатели через параметры
         *xAxisEdit = xEdit;
         *yAxisEdit = yEdit;
+        *detailCombo = detail;
 
         settingsGroup->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
         return settingsGroup;
@@ -226,7 +235,7 @@ namespace Draw {
         QVBoxLayout* layout = new QVBoxLayout(container);
 
         // Создаем и добавляем ChartView
-        QChartView* chartView = new QChartView(new QChart(), container);
+        ChartView* chartView = new ChartView(new QChart(), container);
         chartView->setRenderHint(QPainter::Antialiasing);
         chartView->chart()->setTitle("Точечный график");
         chartView->chart()->setBackgroundBrush(Qt::white);
@@ -265,7 +274,7 @@ namespace Draw {
     }
 
     QWidget*setupGraphSection(QWidget* parent, QLineEdit** xAxisEdit,
-        QLineEdit** yAxisEdit, QWidget** seriesContent)
+        QLineEdit** yAxisEdit, QComboBox** detailCombo, QWidget** seriesContent)
     {
         QWidget* widget = new QWidget(parent);
         widget->setObjectName("graphSection");
@@ -278,7 +287,7 @@ namespace Draw {
         QVBoxLayout* settingsLayout = new QVBoxLayout(settingsContainer);
 
         // Добавляем панели настроек осей и серий
-        settingsLayout->addWidget(createChartSettingsPanel(settingsContainer, xAxisEdit, yAxisEdit));
+        settingsLayout->addWidget(createChartSettingsPanel(settingsContainer, xAxisEdit, yAxisEdit, detailCombo));
         settingsLayout->addWidget(createSeriesSettingsPanel(settingsContainer, seriesContent));
 
         // Создаем разделитель
@@ -376,7 +385,7 @@ namespace Draw {
 
     QWidget* createDistributionSection(QWidget *parent, QLabel **medianLabel, QLabel **modeLabel, QLabel **stdDevLabel,
                                        QLabel **skewnessLabel, QLabel **kurtosisLabel, QLabel **madLabel,
-                                       QLabel **robustStdLabel, QLabel **shapiroWilkLabel, QLabel **densityLabel,
+                                       QLabel **robustStdLabel, QLabel **shapiroWilkWLabel, QLabel **shapiroWilkLabel, QLabel **densityLabel,
                                        QLabel **chiSquareLabel, QLabel **kolmogorovLabel)
     {
         QWidget *section = Draw::createStatSection(parent, "Распределение");
@@ -389,7 +398,8 @@ namespace Draw {
         *kurtosisLabel = Draw::createAndRegisterStatRow(section, layout, "Эксцесс", "—", "kurtosisLabel");
         *madLabel = Draw::createAndRegisterStatRow(section, layout, "Медианное абсолютное отклонение", "—", "madLabel");
         *robustStdLabel = Draw::createAndRegisterStatRow(section, layout, "Робастный стандартный разброс", "—", "robustStdLabel");
-        *shapiroWilkLabel = Draw::createAndRegisterStatRow(section, layout, "Шапиро-Уилк", "—", "shapiroWilkLabel");
+        *shapiroWilkWLabel = Draw::createAndRegisterStatRow(section, layout, "Шапиро-Уилк, W", "—", "shapiroWilkWLabel");
+        *shapiroWilkLabel = Draw::createAndRegisterStatRow(section, layout, "Шапиро-Уилк, p", "—", "shapiroWilkLabel");
         *densityLabel = Draw::createAndRegisterStatRow(section, layout, "Плотность", "—", "densityLabel");
         *chiSquareLabel = Draw::createAndRegisterStatRow(section, layout, "χ²-критерий", "—", "chiSquareLabel");
         *kolmogorovLabel = Draw::createAndRegisterStatRow(section, layout, "Колмогоров-Смирнов", "—", "kolmogorovLabel");
@@ -4,7 +4,10 @@
 #include "import.h"
 #include "export.h"
 #include "globals.h"
+#include "downsample.h"
 #include "numericDelegate.h"
+#include "tableModel.h"
+#include "chartView.h"
 
 #include <QHBoxLayout>
 #include <QSpinBox>
@@ -12,7 +15,6 @@
 #include <QPushButton>
 #include <QIcon>
 #include <QPixmap>
-#include <QTableWidget>
 #include <QMessageBox>
 #include <QHeaderView>
 #include <QFileDialog>
@@ -63,9 +65,9 @@ namespace Draw
     void setSizePolicyFixed(QWidget *w);
     void setupTableActions();
     QScatterSeries* createMarker(double x, double y, QChart* chart, QValueAxis* axisX, QValueAxis* axisY, bool isMax, int markerSize = 10);
-    QTableWidget *setupTable(QWidget *parent);
+    DataTable *setupTable(QWidget *parent);
     void createDataHeader(QWidget *statsPanel, QVBoxLayout *statsLayout);
-    QWidget *setupTablePanel(QWidget *parent, QTableWidget **outTable);
+    QWidget *setupTablePanel(QWidget *parent, DataTable **outTable);
     QWidget *createSeparator(bool horizontal);
     QSpinBox *createSpinBox(QWidget *parent, int max, int value, int min);
     QHBoxLayout *createSpinBoxWithLabel(QWidget *parent, const std::string text, int max, int min);
@@ -75,13 +77,13 @@ namespace Draw
     QWidget *createStatSection(QWidget *parent, const QString &title);     // Создание секции с заголовком
     void addStatRows(QWidget *parent, QLayout *layout, const std::initializer_list<QPair<QString, QString>> &rows);
     void updateStatValue(QWidget *section, const QString &title, const QString &value);
-    QWidget* setupGraphSection(QWidget* parent, QLineEdit** xAxisEdit, QLineEdit** yAxisEdit, QWidget** seriesContent);
+    QWidget* setupGraphSection(QWidget* parent, QLineEdit** xAxisEdit, QLineEdit** yAxisEdit, QComboBox** detailCombo, QWidget** seriesContent);
     QValueAxis* setupAxis(QString name, int a, int b);
     QSplitter* addSplitter(QWidget* parent, QWidget* w1, QWidget* w2, int stretch1, int stretch2);
     QWidget* createExtremesSection(QWidget *parent, QLabel **minLabel, QLabel **maxLabel, QLabel **rangeLabel);
     QWidget* createDistributionSection(QWidget *parent, QLabel **medianLabel, QLabel **modeLabel, QLabel **stdDevLabel,
                                        QLabel **skewnessLabel, QLabel **kurtosisLabel, QLabel **madLabel,
-                                       QLabel **robustStdLabel, QLabel **shapiroWilkLabel, QLabel **densityLabel,
+                                       QLabel **robustStdLabel, QLabel **shapiroWilkWLabel, QLabel **shapiroWilkLabel, QLabel **densityLabel,
                                        QLabel **chiSquareLabel, QLabel **kolmogorovLabel);
     QWidget* createMeansSection(QWidget *parent, QLabel **geometricMeanLabel, QLabel **harmonicMeanLabel, QLabel **rmsLabel, QLabel **trimmedMeanLabel);
     QWidget* createBasicDataSection(QWidget *parent, QLabel **elementCountLabel, QLabel **sumLabel, QLabel **averageLabel);
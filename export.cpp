@@ -2,71 +2,56 @@
 
 namespace Export
 {
-    QList<QVector<double>> collectRowsData(QTableWidget *table)
+    QList<std::vector<double>> collectRowsData(const TableModel *model)
     {
-        QList<QVector<double>> rowsData;
-        for (int row = 0; row < table->rowCount(); ++row)
+        QList<std::vector<double>> rowsData;
+        for (int row = 0; row < model->rowCount(); ++row)
         {
-            QVector<double> rowData;
-            for (int col = 0; col < table->columnCount(); ++col)
-            {
-                if (auto *item = table->item(row, col); item && !item->text().isEmpty())
-                {
-                    bool ok;
-                    double value = item->text().toDouble(&ok);
-                    if (ok) rowData.append(value);
-                }
-            }
-            if (!rowData.isEmpty()) rowsData.append(rowData);
+            if (model->valueCount(row) > 0)
+                rowsData.append(model->rowValues(row));
         }
         return rowsData;
     }
 
-    TableMetrics calculateTableMetrics(QTableWidget *table)
+    TableMetrics calculateTableMetrics(const TableModel *model)
     {
         TableMetrics metrics{0, true};
 
-        for (int row = 0; row < table->rowCount(); ++row)
+        for (int row = 0; row < model->rowCount(); ++row)
         {
-            int lastNonEmptyCol = -1;
-            for (int col = 0; col < table->columnCount(); ++col)
-            {
-                if (auto *item = table->item(row, col); item && !item->text().isEmpty())
-                {
-                    lastNonEmptyCol = col;
-                    metrics.allEmpty = false;
-                }
-            }
+            const int lastNonEmptyCol = model->lastValueColumn(row);
+            if (lastNonEmptyCol >= 0)
+                metrics.allEmpty = false;
             metrics.maxNonEmptyCols = qMax(metrics.maxNonEmptyCols, lastNonEmptyCol + 1);
         }
         return metrics;
     }
 
-    QStringList prepareTableRows(QTableWidget *table, int columns)
+    QStringList prepareTableRows(const TableModel *model, int columns)
     {
         QStringList rows;
-        for (int row = 0; row < table->rowCount(); ++row)
+        for (int row = 0; row < model->rowCount(); ++row)
         {
+            if (model->valueCount(row) == 0)
+                continue;
+
+            const double *values = model->rowData(row);
             QStringList rowData;
             for (int col = 0; col < columns; ++col)
-            {
-                auto *item = table->item(row, col);
-                rowData << (item && !item->text().isEmpty() ? item->text().trimmed() : "-");
-            }
-            if (!rowData.join("").remove("-").isEmpty())
-                rows << rowData.join(" ");
+                rowData << (model->hasValue(row, col) ? TableModel::formatValue(values[col]) : "-");
+            rows << rowData.join(" ");
         }
         return rows;
     }
 
-    QStringList getHeaderLabels(QTableWidget *table, int columns)
+    QStringList getHeaderLabels(const TableModel *model, int columns)
     {
         QStringList headers;
         for (int col = 0; col < columns; ++col)
         {
-            auto *header = table->horizontalHeaderItem(col);
-            headers << (header && !header->text().isEmpty()
-                            ? header->text()
+            const QString header = model->headerData(col, Qt::Horizontal).toString();
+            headers << (!header.isEmpty()
+                            ? header
                             : "Столбец " + QString::number(col + 1));
         }
         return headers;
@@ -100,114 +85,57 @@ namespace Export
         return true;
     }
 
-    QList<QPair<QString, std::function<QString(const QVector<double>&)>>> createMetricHandlers() {
-        const int precision = 2; // Единый формат для всех числовых значений
+    bool calculateAllMetrics(const QList<std::vector<double>>& rowsData, QWidget* parent,
+                             QList<QPair<QString, QString>>& metrics) {
+        const int precision = 2; // В файл пишется не больше двух знаков
         const QString na = "N/A"; // Обозначение для отсутствующих данных
 
-        auto safeCall = [na](auto func, const auto& data, auto... args) -> QString {
-            if(data.isEmpty()) return na;
-            try {
-                std::vector<double> vec(data.begin(), data.end());
-                return QString::number(func(vec, args...), 'f', precision);
-            } catch(...) {
-                return na;
-            }
-        };
-
-        return {
-            {"Количество элементов", [na](const QVector<double>& data) {
-                 return data.isEmpty() ? na : QString::number(data.size());
-             }},
-            {"Сумма", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::getSum, data);
-             }},
-            {"Среднее арифметическое", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::getMean, data);
-             }},
-            {"Геометрическое среднее", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::geometricMean, data);
-             }},
-            {"Гармоническое среднее", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::harmonicMean, data);
-             }},
-            {"Квадратичное среднее", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::rootMeanSquare, data);
-             }},
-            {"Усечённое среднее", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::trimmedMean, data, trimmedMeanPercentage);
-             }},
-            {"Медиана", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::getMedian, data);
-             }},
-            {"Мода", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::getMode, data);
-             }},
-            {"Стандартное отклонение", [=](const QVector<double>& data) {
-                 std::vector<double> vec(data.begin(), data.end());
-                 const double mean = Calculate::getMean(vec);
-                 return safeCall(Calculate::getStandardDeviation, data, mean);
-             }},
-            {"Асимметрия", [=](const QVector<double>& data) {
-                 std::vector<double> vec(data.begin(), data.end());
-                 const double mean = Calculate::getMean(vec);
-                 const double stdDev = Calculate::getStandardDeviation(vec, mean);
-                 return safeCall(Calculate::skewness, data, mean, stdDev);
-             }},
-            {"Эксцесс", [=](const QVector<double>& data) {
-                 std::vector<double> vec(data.begin(), data.end());
-                 const double mean = Calculate::getMean(vec);
-                 const double stdDev = Calculate::getStandardDeviation(vec, mean);
-                 return safeCall(Calculate::kurtosis, data, mean, stdDev);
-             }},
-            {"Медианное абс. отклонение", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::medianAbsoluteDeviation, data);
-             }},
-            {"Робастное стан. отклонение", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::robustStandardDeviation, data);
-             }},
-            {"Тест Шапиро-Уилка", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::shapiroWilkTest, data);
-             }},
-            {"Плотность распределения", [=](const QVector<double>& data) {
-                 if(data.isEmpty()) return na;
-                 std::vector<double> vec(data.begin(), data.end());
-                 const double mean = Calculate::getMean(vec);
-                 return safeCall(Calculate::calculateDensity, data, mean);
-             }},
-            {"χ²-критерий", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::chiSquareTest, data);
-             }},
-            {"Критерий Колмогорова-Смирнова", [=](const QVector<double>& data) {
-                 return safeCall(Calculate::kolmogorovSmirnovTest, data);
-             }},
-            {"Минимум", [=](const QVector<double>& data) {
-                 if(data.isEmpty()) return na;
-                 return QString::number(*std::min_element(data.begin(), data.end()), 'f', precision);
-             }},
-            {"Максимум", [=](const QVector<double>& data) {
-                 if(data.isEmpty()) return na;
-                 return QString::number(*std::max_element(data.begin(), data.end()), 'f', precision);
-             }},
-            {"Размах", [=](const QVector<double>& data) {
-                 if(data.isEmpty()) return na;
-                 const auto [min, max] = std::minmax_element(data.begin(), data.end());
-                 return QString::number(*max - *min, 'f', precision);
-             }}
+        const auto& registry = Metrics::registry();
+        const unsigned inputs = Metrics::requiredInputs();
+        QVector<int> metricIndices(registry.size());
+        std::iota(metricIndices.begin(), metricIndices.end(), 0);
+
+        // Ряды считаются параллельно в пуле потоков. Внутри ряда общие входы
+        // строятся один раз, а независимые метрики над ними раздаются пулу.
+        auto computeRow = [&](const std::vector<double>& rowData) {
+            const Metrics::RowContext row(rowData, inputs);
+            return QtConcurrent::blockingMapped<QStringList>(metricIndices, [&](int i) {
+                if (row.values.empty()) return na;
+                const Metrics::Metric& metric = registry[i];
+                return Metrics::format(Metrics::compute(metric, row), qMin(metric.precision, precision));
+            });
         };
-    }
 
-    QList<QPair<QString, QString>> calculateAllMetrics(const QList<QVector<double>>& rowsData) {
-        const auto handlers = createMetricHandlers();
-        QList<QPair<QString, QString>> metrics;
-
-        for (const auto& handler : handlers) {
+        QProgressDialog progress("Расчёт метрик...", "Отмена", 0, rowsData.size(), parent);
+        progress.setWindowTitle("Экспорт данных");
+        progress.setWindowModality(Qt::WindowModal);
+        progress.setMinimumDuration(300);
+
+        QFutureWatcher<QStringList> watcher;
+        QEventLoop loop;
+        QObject::connect(&watcher, &QFutureWatcherBase::progressValueChanged,
+                         &progress, &QProgressDialog::setValue);
+        QObject::connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+        QObject::connect(&progress, &QProgressDialog::canceled, &watcher, &QFutureWatcherBase::cancel);
+
+        watcher.setFuture(QtConcurrent::mapped(rowsData, computeRow));
+        loop.exec();
+        watcher.waitForFinished();
+        progress.reset();
+
+        if (watcher.isCanceled()) return false;
+
+        // mapped сохраняет порядок входных рядов, поэтому вывод детерминирован
+        const QList<QStringList> rowResults = watcher.future().results();
+        metrics.clear();
+        for (int i = 0; i < registry.size(); ++i) {
             QStringList values;
-            for (const auto& rowData : rowsData) {
-                values << handler.second(rowData);
+            for (const QStringList& rowResult : rowResults) {
+                values << rowResult[i];
             }
-            metrics.append({handler.first, values.join(", ")});
+            metrics.append({registry[i].name, values.join(", ")});
         }
-        return metrics;
+        return true;
     }
 
     bool processExportDialog(const QString& fileName,
@@ -218,21 +146,61 @@ namespace Export
         return writeFileContent(fileName, metrics, tableData, seriesHeaders);
     }
 
-    void exportData(QTableWidget* table, const QList<QPair<QString, QString>>& /*metrics*/) {
+    void exportWorkspace(DataTable* table, const QString& fileName)
+    {
+        // Фоновый импорт ещё дописывает ряды: сохранился бы обрывок файла
+        if (table->property("importRunning").toBool()) {
+            QMessageBox::warning(nullptr, "Ошибка", "Дождитесь окончания импорта!");
+            return;
+        }
+
+        Workspace::Extras extras;
+        if (!Workspace::computeMetrics(table->tableModel(), table->window(), extras.metrics)) return; // Отменено пользователем
+
+        MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window());
+        if (mainWindow) {
+            extras.seriesHeaders = mainWindow->getSeriesHeaders();
+        }
+
+        if (Workspace::save(fileName, table->tableModel(), extras)) {
+            QMessageBox::information(nullptr, "Успех", "Рабочая область сохранена!");
+        } else {
+            QMessageBox::critical(nullptr, "Ошибка", "Ошибка записи файла!");
+        }
+    }
+
+    void exportData(DataTable* table, const QList<QPair<QString, QString>>& /*metrics*/) {
         if (!table) {
             QMessageBox::critical(nullptr, "Ошибка", "Таблица не инициализирована!");
             return;
         }
 
-        const auto rowsData = collectRowsData(table);
+        const auto rowsData = collectRowsData(table->tableModel());
         if (rowsData.isEmpty()) {
             QMessageBox::warning(nullptr, "Ошибка", "Нет данных для экспорта!");
             return;
         }
 
-        const auto metrics = calculateAllMetrics(rowsData);
-        const TableMetrics tableMetrics = calculateTableMetrics(table);
-        const auto tableData = prepareTableRows(table, tableMetrics.maxNonEmptyCols);
+        const QString workspaceFilter = "Рабочая область (*.svb)";
+        QString selectedFilter;
+        QString fileName = QFileDialog::getSaveFileName(
+            nullptr, "Экспорт данных", "", "Текстовый файл (*.txt);;CSV (*.csv);;" + workspaceFilter, &selectedFilter);
+        if (fileName.isEmpty()) return;
+
+        // Диалог не везде дописывает расширение выбранного фильтра сам
+        if (selectedFilter == workspaceFilter && QFileInfo(fileName).suffix().isEmpty()) {
+            fileName += ".svb";
+        }
+        if (Workspace::isWorkspaceFile(fileName)) {
+            exportWorkspace(table, fileName);
+            return;
+        }
+
+        QList<QPair<QString, QString>> metrics;
+        if (!calculateAllMetrics(rowsData, table->window(), metrics)) return; // Отменено пользователем
+
+        const TableMetrics tableMetrics = calculateTableMetrics(table->tableModel());
+        const auto tableData = prepareTableRows(table->tableModel(), tableMetrics.maxNonEmptyCols);
 
         // Получаем заголовки рядов из MainWindow
         MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window());
@@ -241,12 +209,9 @@ namespace Export
             seriesHeaders = mainWindow->getSeriesHeaders();
         }
 
-        const QString fileName = QFileDialog::getSaveFileName(
-            nullptr, "Экспорт данных", "", "Текстовый файл (*.txt);;CSV (*.csv)");
-
         if (processExportDialog(fileName, metrics, tableData, seriesHeaders)) {
             QMessageBox::information(nullptr, "Успех", "Данные экспортированы!");
-        } else if (!fileName.isEmpty()) {
+        } else {
             QMessageBox::critical(nullptr, "Ошибка", "Ошибка записи файла!");
         }
     }
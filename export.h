@@ -1,10 +1,10 @@
 #ifndef EXPORT_H
 #define EXPORT_H
 
-#include <QTableWidget>
 #include <QStringList>
 #include <QFileDialog>
 #include <QFile>
+#include <QFileInfo>
 #include <QTextStream>
 #include <QMessageBox>
 #include <QHeaderView>
@@ -12,12 +12,19 @@
 #include <QString>
 #include <QPair>
 #include <QHash>
+#include <QProgressDialog>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QtConcurrent>
 
 #include <algorithm>
 #include <numeric>
 #include "calculate.h"
 #include "globals.h"
 #include "mainwindow.h"
+#include "metrics.h"
+#include "tableModel.h"
+#include "workspace.h"
 
 struct TableMetrics {
     int maxNonEmptyCols;
@@ -26,12 +33,13 @@ struct TableMetrics {
 
 
 namespace Export {
-    TableMetrics calculateTableMetrics(QTableWidget *table);
-    QStringList prepareTableRows(QTableWidget *table, int columns);
-    QStringList getHeaderLabels(QTableWidget *table, int columns);
+    TableMetrics calculateTableMetrics(const TableModel *model);
+    QStringList prepareTableRows(const TableModel *model, int columns);
+    QStringList getHeaderLabels(const TableModel *model, int columns);
     bool processExportDialog(const QString& fileName, const QList<QPair<QString, QString>>& metrics,
                              const QStringList& tableData, const QStringList& seriesHeaders);
-    void exportData(QTableWidget *table, const QList<QPair<QString, QString>>& metrics);
+    void exportWorkspace(DataTable *table, const QString& fileName);
+    void exportData(DataTable *table, const QList<QPair<QString, QString>>& metrics);
     bool writeFileContent(const QString& path, const QList<QPair<QString, QString>>& metrics, const QStringList& data);
 }
 
@@ -0,0 +1,108 @@
+#include "extremumTree.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ExtremumTree::build(const double* values, int size)
+{
+    m_size = size;
+    const int leaves = (size + EXTREMUM_BLOCK - 1) / EXTREMUM_BLOCK;
+    m_leafBase = 1;
+    while (m_leafBase < leaves) m_leafBase *= 2;
+
+    m_nodes.assign(2 * m_leafBase, -1);
+    for (int leaf = 0; leaf < leaves; ++leaf)
+        m_nodes[m_leafBase + leaf] = leafWinner(values, leaf);
+    for (int node = m_leafBase - 1; node >= 1; --node)
+        m_nodes[node] = pick(values, m_nodes[2 * node], m_nodes[2 * node + 1]);
+
+    m_pending.clear();
+    m_built = true;
+    m_stale = false;
+    m_rebuild = false;
+    m_champion = m_nodes[1];
+    if (m_champion != -1) m_championValue = values[m_champion];
+}
+
+void ExtremumTree::clear()
+{
+    m_nodes = std::vector<int>();
+    m_pending = std::vector<int>();
+    m_built = false;
+    m_champion = -1;
+}
+
+void ExtremumTree::update(const double* values, int column)
+{
+    if (!m_built) return;
+    if (column < 0 || column >= m_size) {
+        m_built = false; // Ширина ряда изменилась без перестройки
+        return;
+    }
+
+    if (static_cast<int>(m_pending.size()) < m_leafBase)
+        m_pending.push_back(column / EXTREMUM_BLOCK);
+    else
+        m_rebuild = true;
+    if (m_stale) return;
+
+    // Чемпион меняется, только если новое значение его превзошло
+    // или сама ячейка чемпиона стала хуже. При равенстве побеждает левый столбец
+    const double value = values[column];
+    if (column == m_champion) {
+        if (!std::isnan(value) && !better(m_championValue, value))
+            m_championValue = value;
+        else
+            m_stale = true;
+    } else if (!std::isnan(value)
+               && (m_champion == -1 || better(value, m_championValue)
+                   || (value == m_championValue && column < m_champion))) {
+        m_champion = column;
+        m_championValue = value;
+    }
+}
+
+int ExtremumTree::champion(const double* values)
+{
+    if (!m_built) return -1;
+    if (m_stale) {
+        if (m_rebuild) {
+            build(values, m_size);
+            return m_champion;
+        }
+        for (int leaf : m_pending)
+            replay(values, leaf);
+        m_pending.clear();
+        m_stale = false;
+        m_champion = m_nodes[1];
+        if (m_champion != -1) m_championValue = values[m_champion];
+    }
+    return m_champion;
+}
+
+int ExtremumTree::pick(const double* values, int left, int right) const
+{
+    if (left == -1) return right;
+    if (right == -1) return left;
+    return better(values[right], values[left]) ? right : left;
+}
+
+int ExtremumTree::leafWinner(const double* values, int leaf) const
+{
+    const int first = leaf * EXTREMUM_BLOCK;
+    const int last = std::min(m_size, first + EXTREMUM_BLOCK);
+    int winner = -1;
+    for (int column = first; column < last; ++column) {
+        if (!std::isnan(values[column]) && (winner == -1 || better(values[column], values[winner])))
+            winner = column;
+    }
+    return winner;
+}
+
+void ExtremumTree::replay(const double* values, int leaf)
+{
+    int node = m_leafBase + leaf;
+    m_nodes[node] = leafWinner(values, leaf);
+    for (node /= 2; node >= 1; node /= 2)
+        m_nodes[node] = pick(values, m_nodes[2 * node], m_nodes[2 * node + 1]);
+}
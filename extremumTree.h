@@ -0,0 +1,43 @@
+#ifndef EXTREMUMTREE_H
+#define EXTREMUMTREE_H
+
+#include "globals.h"
+
+#include <vector>
+
+// Турнирное дерево аргмина или аргмакса ряда таблицы (пропуски — nan).
+// Лист — блок из EXTREMUM_BLOCK столбцов, узел хранит столбец-победитель.
+// Правка ячейки, не задевающая текущий экстремум, стоит O(1): лист только
+// откладывается. Если правка сняла чемпиона, отложенные листы переигрываются
+// по своим путям к корню за O(log n) каждый
+class ExtremumTree
+{
+public:
+    explicit ExtremumTree(bool isMax = false) : m_isMax(isMax) {}
+
+    void build(const double* values, int size);
+    void clear();
+    bool isBuilt() const { return m_built; }
+
+    void update(const double* values, int column); // Ячейка column изменилась
+    int champion(const double* values);            // -1, если значений нет
+
+private:
+    bool better(double a, double b) const { return m_isMax ? a > b : a < b; }
+    int pick(const double* values, int left, int right) const;
+    int leafWinner(const double* values, int leaf) const;
+    void replay(const double* values, int leaf);
+
+    bool m_isMax;
+    bool m_built = false;
+    bool m_stale = false;   // Чемпион снят правкой, нужна переигровка
+    bool m_rebuild = false; // Отложенных листов больше, чем листов: проще построить заново
+    int m_size = 0;
+    int m_leafBase = 0;     // Индекс первого листа, степень двойки
+    std::vector<int> m_nodes;
+    std::vector<int> m_pending;
+    int m_champion = -1;
+    double m_championValue = 0.0;
+};
+
+#endif // EXTREMUMTREE_H
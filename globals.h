@@ -5,6 +5,8 @@
 
 #include <QString>
 
+#include <cstddef>
+
 // Таблица
 constexpr unsigned int initialRowCount = 1;
 constexpr unsigned int initialColCount = 100;
@@ -14,22 +16,23 @@ constexpr int statsPrecision = 3;
 constexpr float trimmedMeanPercentage = 0.1;
 constexpr int MIN_SAMPLE_SIZE = 3;
 constexpr int MAX_SAMPLE_SIZE = 5000;
-constexpr double SW_CRITICAL_VALUE = 0.05; // Шапиро-Уилк
+constexpr unsigned int SW_SUBSAMPLE_SEED = 20240917; // Шапиро-Уилк: подвыборка при n > MAX_SAMPLE_SIZE
 // Ядерная оценка плотности
-constexpr double KDE_BANDWIDTH = 0.5;  // Параметр сглаживания
+constexpr int KDE_GRID_SIZE = 512;     // Узлов сетки для кривой плотности
 constexpr double KDE_EPSILON = 1e-8;   // Для устойчивости вычислений
 // Критерий χ²
 constexpr double CHI2_BINS = 5.0;           // Количество интервалов
 constexpr double CHI2_MIN_EXPECTED = 5.0;
 constexpr double ALPHA_LEVEL = 0.05; // Уровни значимости
-// Критерий Шапиро-Уилка
-constexpr double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
-                    -2.759285104469687e+02, 1.383577518672690e+02,
-                    -3.066479806614716e+01, 2.506628277459239e+00};
-
-constexpr double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
-                    -1.556989798598866e+02, 6.680131188771972e+01,
-                    -1.328068155288572e+01};
+// График: прореживание рядов
+constexpr int LOD_POINTS_PER_PIXEL = 2;   // Точек ряда на пиксель ширины области построения
+constexpr int LTTB_PRESELECT_RATIO = 4;   // Огибающая мин/макс перед LTTB, во столько раз больше выхода
+constexpr std::size_t PYRAMID_BLOCK = 64; // Точек в нижнем блоке пирамиды мин/макс/сумм
+constexpr int EXTREMUM_BLOCK = 64;        // Столбцов в листе дерева маркеров экстремумов
+constexpr double ZOOM_STEP = 1.25;        // Масштаб за один шаг колеса мыши
+
+// Импорт
+constexpr long long IMPORT_CHUNK_BYTES = 8ll << 20; // Минимальный кусок файла для параллельного разбора
 
 // Интерфейс
 const QString na = "—";
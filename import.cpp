@@ -1,89 +1,207 @@
 #include "import.h"
 
+#include <charconv>
+#include <cmath>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
 namespace Import {
-QRegularExpression regex(R"([,;\t\s]+)");
 
+// Ряд файла: значения по столбцам, пропуски ("-") — nan
 struct ParsedRow {
-    QStringList data;
+    std::vector<double> values;
     int lastNonEmptyIndex = -1;
-};
-
-struct ParseResult {
-    QVector<ParsedRow> rows;
-    int maxColumns = 0;
-    QStringList seriesHeaders;
+    bool invalid = false; // В строке есть буквы не в записи числа
 };
 
 // Вспомогательные функции
-bool openFile(QFile& file, QWidget* parent) {
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::critical(parent, "Ошибка", "Не удалось открыть файл.");
-        return false;
-    }
-    return true;
-}
-
 void showError(QWidget* parent, const QString& message) {
     QMessageBox::critical(parent, "Ошибка", message);
 }
 
-QList<int> findInvalidDataLines(const QString& filePath, QWidget* parent) {
-    QFile file(filePath);
-    QList<int> invalidLines;
-    QRegularExpression letterRegex("[A-Za-zА-Яа-яЁё]"); // Регулярка для поиска букв
-
-    if (!openFile(file, parent)) return invalidLines;
-
-    QTextStream in(&file);
-    int lineNumber = 0;
-    int emptyLineCounter = 0;
-    const int STOP_LINES = 3;
+// Пробельные символы строки и разделители значений: то же, что [,;\t\s]
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
 
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        lineNumber++;
+inline bool isDelimiter(char c) {
+    return c == ',' || c == ';' || isSpace(c);
+}
 
-        if (line.isEmpty()) {
-            emptyLineCounter++;
-            if (emptyLineCounter >= STOP_LINES) break;
-            continue;
-        } else {
-            emptyLineCounter = 0;
+// Латиница или кириллица [A-Za-zА-Яа-яЁё] в UTF-8
+bool hasLetter(const char* pos, const char* end) {
+    for (; pos < end; ++pos) {
+        const unsigned char c = static_cast<unsigned char>(*pos);
+        if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') return true;
+        if (pos + 1 < end) {
+            const unsigned char next = static_cast<unsigned char>(pos[1]);
+            if (c == 0xD0 && (next == 0x81 || (next >= 0x90 && next <= 0xBF))) return true;
+            if (c == 0xD1 && (next == 0x91 || (next >= 0x80 && next <= 0x8F))) return true;
+        }
+    }
+    return false;
+}
 
-            // Проверка на наличие букв в непустых строках данных
-            if (line.contains(letterRegex)) {
-                invalidLines.append(lineNumber);
+// Отображение файла в память; если отобразить нельзя, файл читается целиком
+struct MappedFile {
+    QFile file;
+    QByteArray buffer;
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    bool open(const QString& filePath) {
+        file.setFileName(filePath);
+        if (!file.open(QIODevice::ReadOnly)) return false;
+
+        const qint64 size = file.size();
+        if (size > 0) {
+            if (uchar* data = file.map(0, size)) {
+                begin = reinterpret_cast<const char*>(data);
+            } else {
+                buffer = file.readAll();
+                begin = buffer.constData();
             }
         }
+        end = begin + (begin ? size : 0);
+
+        // Метку порядка байтов UTF-8 QTextStream пропускал сам
+        if (end - begin >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0) begin += 3;
+        return true;
     }
-    file.close();
-    return invalidLines;
+};
+
+// Следующая строка [begin, lineEnd) без пробелов по краям; pos переходит за перевод строки
+inline void nextLine(const char*& pos, const char* end, const char*& begin, const char*& lineEnd) {
+    const char* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    lineEnd = newline ? newline : end;
+    begin = pos;
+    pos = newline ? newline + 1 : end;
+
+    while (begin < lineEnd && isSpace(*begin)) ++begin;
+    while (lineEnd > begin && isSpace(lineEnd[-1])) --lineEnd;
 }
 
-ParsedRow parseLine(const QString& line) {
+// Разбор строки без промежуточных строк: разделители пропускаются вручную,
+// числа читаются std::from_chars сразу в double
+ParsedRow parseLine(const char* pos, const char* end) {
     ParsedRow row;
-    QStringList tokens = line.split(regex, Qt::SkipEmptyParts);
-
-    for (int i = 0; i < tokens.size(); ++i) {
-        QString token = tokens[i].trimmed();
-        if (token == "-") {
-            row.data.append("");
-        } else if (!token.isEmpty()) {
-            row.data.append(token);
-            row.lastNonEmptyIndex = i;
+    int index = 0;
+
+    while (pos < end) {
+        while (pos < end && isDelimiter(*pos)) ++pos;
+        if (pos == end) break;
+
+        const char* token = pos;
+        while (pos < end && !isDelimiter(*pos)) ++pos;
+
+        double value = std::numeric_limits<double>::quiet_NaN();
+        if (!(pos - token == 1 && *token == '-')) {
+            // from_chars не принимает ведущий плюс, QLocale::toDouble принимал
+            const char* number = (*token == '+' && pos - token > 1) ? token + 1 : token;
+            double parsed;
+            const auto [ptr, ec] = std::from_chars(number, pos, parsed);
+            if (ec == std::errc() && ptr == pos && std::isfinite(parsed)) {
+                value = parsed;
+            } else if (hasLetter(token, pos)) {
+                row.invalid = true; // Буква допустима только как порядок числа: 1e-07
+            }
+            row.lastNonEmptyIndex = index; // Нечисловой токен — пустая ячейка, но столбец занимает
         }
+        row.values.push_back(value);
+        ++index;
     }
     return row;
 }
 
-void adjustRows(QVector<ParsedRow>& rows, int maxColumns) {
-    for (ParsedRow& row : rows) {
-        while (row.data.size() > maxColumns)
-            row.data.removeLast();
+// Кусок файла, выровненный по переводам строк, и итог его разбора.
+// Пустые строки по краям куска нужны, чтобы найти три пустые строки подряд
+// на стыке кусков
+struct ChunkResult {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    QVector<ParsedRow> rows;
+    std::vector<int> rowLines;  // Номер строки в куске для каждого ряда
+    QList<int> invalidLines;    // Номера строк с буквами, с нуля
+    int lineCount = 0;
+    int leadingBlank = 0;
+    int trailingBlank = 0;
+    bool allBlank = true;
+    int firstStop = -1;         // Третья пустая строка подряд внутри куска
+};
 
-        while (row.data.size() < maxColumns)
-            row.data.append("");
+constexpr int STOP_LINES = 3;  // Количество пустых строк для остановки
+
+std::vector<ChunkResult> splitChunks(const char* begin, const char* end) {
+    const qint64 size = end - begin;
+    const int count = static_cast<int>(qBound<qint64>(1, size / IMPORT_CHUNK_BYTES,
+                                                     4 * QThread::idealThreadCount()));
+    std::vector<ChunkResult> chunks;
+    const char* pos = begin;
+    for (int i = 1; i <= count && pos < end; ++i) {
+        const char* chunkEnd = end;
+        if (i < count) {
+            const char* cut = std::max(pos, begin + size * i / count);
+            const char* newline = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        ChunkResult chunk;
+        chunk.begin = pos;
+        chunk.end = chunkEnd;
+        chunks.push_back(std::move(chunk));
+        pos = chunkEnd;
     }
+    return chunks;
+}
+
+ChunkResult parseChunk(const ChunkResult& chunk) {
+    ChunkResult result;
+    result.begin = chunk.begin;
+    result.end = chunk.end;
+
+    int emptyLineCounter = 0;
+    const char* pos = chunk.begin;
+    const char* line = nullptr;
+    const char* lineEnd = nullptr;
+    while (pos < chunk.end) {
+        nextLine(pos, chunk.end, line, lineEnd);
+        const int lineIndex = result.lineCount++;
+
+        // Проверяем разделитель окончания данных
+        if (line == lineEnd) {
+            if (result.allBlank) result.leadingBlank++;
+            emptyLineCounter++;
+            if (emptyLineCounter >= STOP_LINES) {
+                result.firstStop = lineIndex; // Дальше данных нет
+                break;
+            }
+            continue;
+        }
+        result.allBlank = false;
+        emptyLineCounter = 0;
+
+        ParsedRow row = parseLine(line, lineEnd);
+        if (row.invalid) {
+            result.invalidLines.append(lineIndex);
+        } else if (row.lastNonEmptyIndex >= 0 && result.invalidLines.isEmpty()) {
+            result.rows.append(std::move(row));
+            result.rowLines.push_back(lineIndex);
+        }
+    }
+    result.trailingBlank = emptyLineCounter;
+    return result;
+}
+
+// Позиция после первых count строк
+const char* skipLines(const char* pos, const char* end, int count) {
+    const char* line = nullptr;
+    const char* lineEnd = nullptr;
+    for (int i = 0; i < count && pos < end; ++i) {
+        nextLine(pos, end, line, lineEnd);
+    }
+    return pos;
 }
 
 // Основные функции
@@ -92,108 +210,238 @@ QString getFilePath(QWidget* parent) {
         parent,
         "Импорт файла данных",
         "",
-        "Файлы данных (*.csv *.txt);;Все файлы (*)"
+        "Файлы данных (*.csv *.txt);;Рабочая область (*.svb);;Все файлы (*)"
         );
 }
 
-ParseResult readAndParseFile(const QString& filePath, QWidget* parent) {
-    QFile file(filePath);
-    ParseResult result;
-    int emptyLineCounter = 0;  // Счетчик пустых строк
-    const int STOP_LINES = 3;  // Количество пустых строк для остановки
+// Фоновый импорт: куски файла разбираются в пуле потоков, а готовые по порядку
+// куски склеиваются в потоке интерфейса и сразу дописываются в таблицу.
+// Отображение файла живёт, пока не остановятся все задачи
+struct ImportJob {
+    DataTable* table = nullptr;
+    MappedFile mapped;
+    std::vector<ChunkResult> chunks;
+    std::unique_ptr<std::atomic<bool>[]> parsed; // Кусок разобран и может быть склеен
+    QFuture<void> future;
+    QProgressDialog* progress = nullptr;
+    QAbstractItemView::EditTriggers editTriggers;
+
+    size_t nextChunk = 0;
+    int lineBase = 0;                 // Строк в склеенных кусках
+    int blankRun = 0;                 // Пустых строк подряд в конце склеенных кусков
+    const char* trailer = nullptr;    // Начало области после окончания данных
+    QList<int> invalidLines;
+    int rowsLoaded = 0;
+    bool canceled = false;
 
-    QList<int> invalidLines = findInvalidDataLines(filePath, parent);
-    if (!invalidLines.isEmpty()) {
-        QString errorMsg = "Невозможно импортировать. Найдены буквы в строках:\n";
-        for (int ln : invalidLines) {
-            errorMsg += QString::number(ln) + ", ";
-        }
-        errorMsg.chop(2);
-        showError(parent, errorMsg);
-        return result;
-    }
+    // Таблица до импорта: возвращается, если файл не загрузился до конца
+    std::vector<std::vector<double>> previousRows;
+    int previousColumns = 0;
+};
 
-    if (!openFile(file, parent)) return result;
+// Склейка одного куска; ряды сразу уходят в таблицу одной пачкой
+void appendChunk(ImportJob* job, ChunkResult& chunk) {
+    int stop = chunk.firstStop;
+    if (job->blankRun + chunk.leadingBlank >= STOP_LINES) {
+        stop = STOP_LINES - job->blankRun - 1; // Серия пустых строк началась в прошлых кусках
+    }
 
-    QTextStream in(&file);
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
+    for (int line : chunk.invalidLines) {
+        if (stop != -1 && line > stop) break;
+        job->invalidLines.append(job->lineBase + line + 1);
+    }
 
-        // Проверяем разделитель окончания данных
-        if (line.isEmpty()) {
-            emptyLineCounter++;
-            if (emptyLineCounter >= STOP_LINES) {
-                break; // Обнаружен конец данных
-            }
-            continue;
-        } else {
-            emptyLineCounter = 0; // Сбрасываем счетчик
+    std::vector<std::vector<double>> batch;
+    if (job->invalidLines.isEmpty()) {
+        batch.reserve(chunk.rows.size());
+        for (int i = 0; i < chunk.rows.size(); ++i) {
+            if (stop != -1 && chunk.rowLines[i] > stop) break;
+            std::vector<double>& values = chunk.rows[i].values;
+            values.resize(chunk.rows[i].lastNonEmptyIndex + 1); // Пустой хвост не расширяет таблицу
+            batch.push_back(std::move(values));
         }
+    }
 
-        ParsedRow row = parseLine(line);
-        if (row.lastNonEmptyIndex >= 0) {
-            result.rows.append(row);
-            result.maxColumns = std::max(result.maxColumns, row.lastNonEmptyIndex + 1);
-        }
+    if (stop != -1) {
+        job->trailer = skipLines(chunk.begin, chunk.end, stop + 1);
+    } else {
+        job->blankRun = chunk.allBlank ? job->blankRun + chunk.lineCount : chunk.trailingBlank;
+        job->lineBase += chunk.lineCount;
+    }
+    chunk = ChunkResult(); // Ряды уже в таблице
+
+    if (!batch.empty()) {
+        // Старые данные заменяются одним сбросом модели, когда пришла первая
+        // пачка нового файла, и откладываются до конца импорта; остальные пачки дописываются
+        TableModel* model = job->table->tableModel();
+        const bool first = job->rowsLoaded == 0;
+        job->rowsLoaded += static_cast<int>(batch.size());
+        if (first)
+            job->previousRows = model->replaceRows(std::move(batch));
+        else
+            model->appendRows(std::move(batch));
     }
+}
 
-    QVector<QString> seriesHeaders;
-    while(!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if(line.startsWith("# Заголовки рядов")) {
-            if(!in.atEnd()) {
-                QString headersLine = in.readLine().trimmed();
-                seriesHeaders = headersLine.split(", ", Qt::SkipEmptyParts);
+// Склеивает все разобранные подряд куски; после окончания данных разбор не нужен
+void appendReadyChunks(ImportJob* job) {
+    while (!job->canceled && !job->trailer && job->invalidLines.isEmpty()
+           && job->nextChunk < job->chunks.size()
+           && job->parsed[job->nextChunk].load(std::memory_order_acquire)) {
+        appendChunk(job, job->chunks[job->nextChunk++]);
+    }
+    if (job->trailer || !job->invalidLines.isEmpty()) {
+        job->future.cancel();
+    }
+    job->progress->setValue(static_cast<int>(job->nextChunk));
+}
+
+QStringList readSeriesHeaders(const char* pos, const char* end) {
+    const QByteArray headersMarker = QByteArray("# Заголовки рядов");
+    const char* line = nullptr;
+    const char* lineEnd = nullptr;
+    while (pos < end) {
+        nextLine(pos, end, line, lineEnd);
+        if (QByteArray::fromRawData(line, lineEnd - line).startsWith(headersMarker)) {
+            if (pos < end) {
+                nextLine(pos, end, line, lineEnd);
+                return QString::fromUtf8(line, lineEnd - line).split(", ", Qt::SkipEmptyParts);
             }
             break;
         }
     }
-    result.seriesHeaders = seriesHeaders;
+    return QStringList();
+}
 
-    file.close();
-    adjustRows(result.rows, result.maxColumns);
-    return result;
+// Ошибка или отмена: загруженные ряды убираются, таблица становится такой,
+// какой была до импорта
+void restorePrevious(ImportJob* job) {
+    if (job->rowsLoaded == 0) return; // Таблицу ещё не трогали
+
+    job->table->tableModel()->loadRows(std::move(job->previousRows), job->previousColumns);
 }
 
-void updateTable(QTableWidget* table, const ParseResult& result) {
-    if (result.rows.isEmpty()) {
-        QMessageBox::warning(table, "Предупреждение", "Файл пуст!");
-        return;
-    }
+QStringList readSeriesHeaders(const QString& filePath) {
+    MappedFile mapped;
+    if (!mapped.open(filePath)) return QStringList();
+    return readSeriesHeaders(mapped.begin, mapped.end);
+}
 
-    table->clearContents();
-    table->setRowCount(result.rows.size());
-    table->setColumnCount(result.maxColumns);
+void finishImport(ImportJob* job) {
+    appendReadyChunks(job);
+    DataTable* table = job->table;
+    MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window());
 
-    for (int i = 0; i < result.rows.size(); ++i) {
-        const auto& rowData = result.rows[i].data;
-        for (int j = 0; j < result.maxColumns; ++j) {
-            if (j < rowData.size() && !rowData[j].isEmpty()) {
-                QTableWidgetItem* item = new QTableWidgetItem(rowData[j]);
-                table->setItem(i, j, item);
+    if (!job->invalidLines.isEmpty()) {
+        // Файл с буквами не импортируется
+        restorePrevious(job);
+        QString errorMsg = "Невозможно импортировать. Найдены буквы в строках:\n";
+        for (int ln : job->invalidLines) {
+            errorMsg += QString::number(ln) + ", ";
+        }
+        errorMsg.chop(2);
+        showError(table, errorMsg);
+    } else if (job->canceled) {
+        restorePrevious(job);
+    } else {
+        if (job->rowsLoaded == 0) {
+            QMessageBox::warning(table, "Предупреждение", "Файл пуст!");
+        } else {
+            const QStringList seriesHeaders = job->trailer ? readSeriesHeaders(job->trailer, job->mapped.end)
+                                                           : QStringList();
+            if (mainWindow && !seriesHeaders.isEmpty()) {
+                mainWindow->setSeriesHeaders(seriesHeaders);
             }
+            table->resizeColumnsToContents();
+            table->resizeRowsToContents();
         }
     }
 
-    MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window());
-    if(mainWindow && !result.seriesHeaders.isEmpty()) {
-        mainWindow->setSeriesHeaders(result.seriesHeaders);
+    table->setEditTriggers(job->editTriggers);
+    table->setProperty("importRunning", false);
+    if (mainWindow) {
+        mainWindow->setTableLocked(false);
     }
+    job->progress->deleteLater();
+    delete job;
+}
 
+// Рабочая область читается целиком из отображения файла без разбора текста,
+// поэтому открывается сразу, без фоновой задачи
+void importWorkspace(DataTable* table, const QString& filePath) {
+    Workspace::Extras extras;
+    QString error;
+    if (!Workspace::load(filePath, table->tableModel(), extras, error)) {
+        showError(table, error);
+        return;
+    }
+
+    MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window());
+    if (mainWindow) {
+        mainWindow->setSeriesHeaders(extras.seriesHeaders);
+        mainWindow->setCachedMetrics(extras.metrics);
+    }
     table->resizeColumnsToContents();
     table->resizeRowsToContents();
 }
 
-void importFile(QTableWidget* table) {
+void importFile(DataTable* table) {
+    if (table->property("importRunning").toBool()) return;
+
     const QString filePath = getFilePath(table);
     if (filePath.isEmpty()) return;
-    const auto parseResult = readAndParseFile(filePath, table);
+    if (Workspace::isWorkspaceFile(filePath)) {
+        importWorkspace(table, filePath);
+    } else {
+        importTextFile(table, filePath);
+    }
+}
+
+void importTextFile(DataTable* table, const QString& filePath) {
+    if (table->property("importRunning").toBool()) return;
 
-    // Уже была показана ошибка, выходим
-    if (parseResult.rows.isEmpty() && parseResult.seriesHeaders.isEmpty()) {
+    ImportJob* job = new ImportJob;
+    if (!job->mapped.open(filePath)) {
+        showError(table, "Не удалось открыть файл.");
+        delete job;
         return;
     }
+    job->table = table;
+    job->chunks = splitChunks(job->mapped.begin, job->mapped.end);
+    job->parsed.reset(new std::atomic<bool>[job->chunks.size()]);
+    for (size_t i = 0; i < job->chunks.size(); ++i) {
+        job->parsed[i].store(false);
+    }
+
+    // Пока идёт импорт, таблицу можно смотреть, но не править и не менять её размеры
+    job->editTriggers = table->editTriggers();
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setProperty("importRunning", true);
+    job->previousColumns = table->columnCount();
+    if (MainWindow* mainWindow = qobject_cast<MainWindow*>(table->window())) {
+        mainWindow->setTableLocked(true);
+    }
 
-    updateTable(table, parseResult);
+    job->progress = new QProgressDialog("Импорт данных...", "Отмена", 0, static_cast<int>(job->chunks.size()), table);
+    job->progress->setWindowTitle("Импорт");
+    job->progress->setAutoClose(false);
+    job->progress->setAutoReset(false);
+    job->progress->setMinimumDuration(300);
+
+    auto* watcher = new QFutureWatcher<void>(job->progress);
+    QObject::connect(watcher, &QFutureWatcher<void>::progressValueChanged,
+                     job->progress, [job]() { appendReadyChunks(job); });
+    QObject::connect(watcher, &QFutureWatcher<void>::finished,
+                     job->progress, [job]() { finishImport(job); });
+    QObject::connect(job->progress, &QProgressDialog::canceled, job->progress, [job]() {
+        job->canceled = true; // Загруженные ряды убираются в finishImport
+        job->future.cancel();
+    });
+
+    job->future = QtConcurrent::map(job->chunks, [job](ChunkResult& chunk) {
+        chunk = parseChunk(chunk);
+        job->parsed[&chunk - job->chunks.data()].store(true, std::memory_order_release);
+    });
+    watcher->setFuture(job->future);
 }
 }
@@ -2,7 +2,6 @@
 #define IMPORT_H
 
 #include <QWidget>
-#include <QTableWidget>
 #include <QStringList>
 #include <QRegularExpression>
 #include <QFileDialog>
@@ -11,15 +10,24 @@
 #include <QMessageBox>
 #include <QHeaderView>
 #include <QFileInfo>
+#include <QThread>
+#include <QProgressDialog>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 #include "mainwindow.h"
+#include "tableModel.h"
+#include "workspace.h"
 
 namespace Import {
     QString getFilePath(QWidget *parent);
     QString readSingleLineFile(const QString &filePath, QWidget *parent); // Возвращает одну строку
     QStringList parseData(const QString &line, const QRegularExpression &regex);
-    void updateTableWithData(QTableWidget *table, const QStringList &data);
-    void importFile(QTableWidget *table);
+    void updateTableWithData(DataTable *table, const QStringList &data);
+    QStringList readSeriesHeaders(const QString &filePath); // Заголовки рядов из хвоста текстового файла
+    void importWorkspace(DataTable *table, const QString &filePath);
+    void importTextFile(DataTable *table, const QString &filePath); // Возвращается сразу, импорт идёт в фоне
+    void importFile(DataTable *table);
 }
 
 #endif // IMPORT_H
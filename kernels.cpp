@@ -0,0 +1,1152 @@
+#include "kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define KERNEL_TARGET(isa)
+#endif
+
+namespace Kernels
+{
+    constexpr double LN2 = 0.693147180559945309417232121458;
+    // Произведение мантисс из [1, 2) не переполнится за 256 шагов: 2^256 < DBL_MAX
+    constexpr int RENORMALIZE_STEPS = 256;
+    constexpr std::int64_t MANTISSA_MASK = 0x000FFFFFFFFFFFFFLL;
+    constexpr std::int64_t ONE_BITS = 0x3FF0000000000000LL;
+    constexpr std::int64_t EXPONENT_BIAS = 1023;
+
+    // Нормальное распределение. Все приближения без ветвлений, чтобы векторные
+    // версии считали те же формулы по дорожкам, что и скалярная.
+    constexpr double SHIFTER = 6755399441055744.0; // 1.5·2^52: округление к целому сложением
+    constexpr double TWO52 = 4503599627370496.0;
+    constexpr double LOG2E = 1.44269504088896340736;
+    constexpr double LN2_HI = 6.93147180369123816490e-01; // ln2 = LN2_HI + LN2_LO
+    constexpr double LN2_LO = 1.90821492927058770002e-10;
+    constexpr double EXP_MIN = -708.39; // Ниже — субнормальные числа, результат обнуляется
+    constexpr double EXP_MAX = 709.0;
+    constexpr double SPLITTER = 134217729.0; // 2^27 + 1, разбиение Вельткампа
+    constexpr double CDF_MAX_ABS = 56.0; // Φ(-56) < 1e-680: дальше хвост равен нулю
+    constexpr double SQRT2 = 1.41421356237309504880;
+    constexpr double SQRT1_2 = 0.70710678118654752440;
+    constexpr double SQRT_2PI = 2.50662827463100050242;
+    constexpr double INV_SQRT_PI = 0.56418958354775628695;
+    constexpr double DBL_MIN_NORMAL = 2.2250738585072014e-308;
+    constexpr double ACKLAM_P_LOW = 0.02425;
+
+    // e^r на |r| <= ln2/2: ряд Тейлора до r^13, остаток < 5e-18
+    constexpr double EXP_TAYLOR[] = {1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0,
+                                     1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0,
+                                     1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0};
+    // ln(m) = 2·atanh(s), s = (m-1)/(m+1), |s| <= 0.1716: коэффициенты 1/(2k+1)
+    constexpr double LOG_SERIES[] = {1.0 / 23, 1.0 / 21, 1.0 / 19, 1.0 / 17, 1.0 / 15, 1.0 / 13,
+                                     1.0 / 11, 1.0 / 9, 1.0 / 7, 1.0 / 5, 1.0 / 3, 1.0};
+    // erf(y)·√π/(2y) = Σ (-1)^n y^2n / (n!(2n+1)) при |y| < 0.36
+    constexpr double ERF_SERIES[] = {-1.0 / (39916800.0 * 23), 1.0 / (3628800.0 * 21), -1.0 / (362880.0 * 19),
+                                     1.0 / (40320.0 * 17), -1.0 / (5040.0 * 15), 1.0 / (720.0 * 13),
+                                     -1.0 / (120.0 * 11), 1.0 / (24.0 * 9), -1.0 / (6.0 * 7), 1.0 / (2.0 * 5),
+                                     -1.0 / 3, 1.0};
+    // ln(erfc(z)·e^(z²)/t) как многочлен 27-й степени от u = 2t-1, t = 2/(2+z) ∈ (0, 1].
+    // Получен в long double из разложения Чебышёва по 96 узлам (отброшенный хвост < 3e-18);
+    // абсолютная ошибка вычисления в double < 4e-16. Чётная и нечётная части считаются
+    // двумя независимыми цепочками Горнера по u², чтобы не ждать задержку умножений.
+    constexpr double ERFC_EVEN[] = {
+        4.055664248880930244923e-09, -3.913445804452445979027e-08, 1.532252629961779651629e-07,
+        -1.682804520915700171177e-07, -1.272570177827484864558e-06, 8.562830613456640094228e-06,
+        -3.018799897068028907125e-05, 7.140105760256495089099e-05, -9.373504233675782522394e-05,
+        -1.462468615128752665452e-04, 1.758933557610139553315e-03, -9.872689366379765750298e-03,
+        4.734330684190420314024e-02, -6.717940840566922650902e-01};
+    constexpr double ERFC_ODD[] = {
+        -1.871133766447504361403e-09, 1.104403205924124146447e-08, 1.829012793071645624606e-09,
+        -2.502591958849128180322e-07, 1.250804228784356079476e-06, -2.948598893344941037192e-06,
+        1.380647911923086700645e-07, 3.174504831766437422039e-05, -1.743029117368237919934e-04,
+        6.736787891512378834147e-04, -2.345812499747206217225e-03, 8.824938557013196290667e-03,
+        -4.689561023117392313456e-02, 6.726432239776567181756e-01};
+    // Начальное приближение квантиля (алгоритм Акклама): центр A/B, хвост C/D
+    constexpr double ACKLAM_A[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                   1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    constexpr double ACKLAM_B[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                   6.680131188771972e+01, -1.328068155288572e+01, 1.0};
+    constexpr double ACKLAM_C[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                   -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    constexpr double ACKLAM_D[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                   3.754408661907416e+00, 1.0};
+
+    template<std::size_t N>
+    constexpr int terms(const double (&)[N]) { return static_cast<int>(N); }
+
+    namespace Scalar
+    {
+        double sum(const double *data, std::size_t size)
+        {
+            NeumaierSum acc;
+            for (std::size_t i = 0; i < size; ++i)
+                acc.add(data[i]);
+            return acc.value();
+        }
+
+        MinMax minMax(const double *data, std::size_t size)
+        {
+            MinMax result{std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                result.min = std::min(result.min, data[i]);
+                result.max = std::max(result.max, data[i]);
+            }
+            return result;
+        }
+
+        PowerSums centralPowerSums(const double *data, std::size_t size, double center)
+        {
+            NeumaierSum s1, s2, s3, s4;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const double d = data[i] - center;
+                const double d2 = d * d;
+                s1.add(d);
+                s2.add(d2);
+                s3.add(d2 * d);
+                s4.add(d2 * d2);
+            }
+            return {s1.value(), s2.value(), s3.value(), s4.value()};
+        }
+
+        double reciprocalSum(const double *data, std::size_t size)
+        {
+            NeumaierSum acc;
+            for (std::size_t i = 0; i < size; ++i)
+                acc.add(1.0 / data[i]);
+            return acc.value();
+        }
+
+        double logSum(const double *data, std::size_t size)
+        {
+            NeumaierSum acc;
+            for (std::size_t i = 0; i < size; ++i)
+                acc.add(std::log(data[i]));
+            return acc.value();
+        }
+
+        double horner(double x, const double *c, int n)
+        {
+            double result = c[0];
+            for (int i = 1; i < n; ++i)
+                result = result * x + c[i];
+            return result;
+        }
+
+        double fromBits(std::int64_t bits)
+        {
+            double value;
+            std::memcpy(&value, &bits, sizeof value);
+            return value;
+        }
+
+        std::int64_t toBits(double value)
+        {
+            std::int64_t bits;
+            std::memcpy(&bits, &value, sizeof bits);
+            return bits;
+        }
+
+        // e^y: y = k·ln2 + r, 2^k собирается прямо в битах порядка
+        double exp(double y)
+        {
+            const bool underflow = y < EXP_MIN;
+            y = std::min(std::max(y, EXP_MIN), EXP_MAX);
+            const double kd = y * LOG2E + SHIFTER;
+            const double k = kd - SHIFTER;
+            const double r = (y - k * LN2_HI) - k * LN2_LO;
+            const double scale = fromBits((toBits(kd) + EXPONENT_BIAS) << 52);
+            return underflow ? 0.0 : horner(r, EXP_TAYLOR, terms(EXP_TAYLOR)) * scale;
+        }
+
+        // ln x для нормализованных x > 0
+        double log(double x)
+        {
+            const std::int64_t bits = toBits(x);
+            double m = fromBits((bits & MANTISSA_MASK) | ONE_BITS);
+            double e = fromBits((bits >> 52) | toBits(TWO52)) - TWO52 - EXPONENT_BIAS;
+            const bool high = m > SQRT2;
+            m = high ? m * 0.5 : m;
+            e = high ? e + 1.0 : e;
+            const double s = (m - 1.0) / (m + 1.0);
+            return e * LN2_HI + (2.0 * s * horner(s * s, LOG_SERIES, terms(LOG_SERIES)) + e * LN2_LO);
+        }
+
+        // 0.5·erfc(|x|/√2) = t/2·exp(-x²/2 + P(2t-1)). x² раскладывается точно (hi + lo),
+        // иначе ошибка округления x² растёт в хвосте как ε·x²
+        double tail(double x)
+        {
+            const double ax = std::min(std::abs(x), CDF_MAX_ABS);
+            const double t = 2.0 / (2.0 + ax * SQRT1_2);
+            const double u = 2.0 * t - 1.0;
+            const double u2 = u * u;
+            const double f = horner(u2, ERFC_EVEN, terms(ERFC_EVEN)) + u * horner(u2, ERFC_ODD, terms(ERFC_ODD));
+
+            const double c = SPLITTER * ax;
+            const double xh = c - (c - ax);
+            const double xl = ax - xh;
+            const double hi = ax * ax;
+            const double lo = ((xh * xh - hi) + 2.0 * xh * xl) + xl * xl;
+
+            // Сумма -hi/2 + (f - lo/2) с точной ошибкой округления (TwoSum)
+            const double a = -0.5 * hi, b = f - 0.5 * lo;
+            const double y = a + b;
+            const double bb = y - a;
+            const double err = (a - (y - bb)) + (b - bb);
+            return 0.5 * t * exp(y) * (1.0 + err);
+        }
+
+        double normalCdfLane(double x)
+        {
+            const double h = tail(x);
+            const double result = x < 0.0 ? h : 1.0 - h;
+            return x == x ? result : x;
+        }
+
+        // Акклам + шаг Галлея. Считается нижний квантиль для min(p, 1-p), верхний —
+        // по симметрии; возле медианы невязка берётся через ряд erf без вычитания 0.5
+        double normalQuantileLane(double p)
+        {
+            const double pp = std::min(p, 1.0 - p);
+
+            const double q = pp - 0.5;
+            const double r = q * q;
+            const double central = horner(r, ACKLAM_A, terms(ACKLAM_A)) * q / horner(r, ACKLAM_B, terms(ACKLAM_B));
+            const double qt = std::sqrt(-2.0 * log(std::max(pp, DBL_MIN_NORMAL)));
+            const double lower = horner(qt, ACKLAM_C, terms(ACKLAM_C)) / horner(qt, ACKLAM_D, terms(ACKLAM_D));
+            double x = pp < ACKLAM_P_LOW ? lower : central;
+
+            const double y = x * SQRT1_2;
+            const double halfErf = y * INV_SQRT_PI * horner(y * y, ERF_SERIES, terms(ERF_SERIES));
+            const double e = std::abs(x) < 0.5 ? halfErf - q : tail(x) - pp;
+            const double u = e * SQRT_2PI * exp(0.5 * x * x);
+            x = x - u / (1.0 + 0.5 * x * u);
+
+            const bool valid = p > 0.0 && p < 1.0;
+            return valid ? (p > 0.5 ? -x : x) : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        void normalCdf(const double *in, double *out, std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+                out[i] = normalCdfLane(in[i]);
+        }
+
+        void normalQuantile(const double *in, double *out, std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+                out[i] = normalQuantileLane(in[i]);
+        }
+    }
+
+#ifdef KERNELS_X86
+    // Логарифм суммы считается как Σ порядков·ln2 + ln(Π мантисс): порядки складываются
+    // точно в целых, а мантиссы перемножаются по дорожкам с периодической нормализацией.
+    // Так ядро обходится без векторного логарифма.
+    double finishLogSum(const double *products, const std::int64_t *exponents, int lanes,
+                        std::int64_t biasCount, const double *tail, std::size_t tailSize)
+    {
+        NeumaierSum acc;
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            acc.add(std::log(products[lane]));
+            acc.add(static_cast<double>(exponents[lane] - EXPONENT_BIAS * biasCount) * LN2);
+        }
+        for (std::size_t i = 0; i < tailSize; ++i)
+            acc.add(std::log(tail[i]));
+        return acc.value();
+    }
+
+    void addLanes(NeumaierSum &acc, const double *lanes, int count)
+    {
+        for (int i = 0; i < count; ++i)
+            acc.add(lanes[i]);
+    }
+
+    namespace Sse2
+    {
+        KERNEL_TARGET("sse2") inline void neumaier(__m128d &s, __m128d &c, __m128d x)
+        {
+            const __m128d signMask = _mm_set1_pd(-0.0);
+            const __m128d t = _mm_add_pd(s, x);
+            const __m128d ge = _mm_cmpge_pd(_mm_andnot_pd(signMask, s), _mm_andnot_pd(signMask, x));
+            const __m128d big = _mm_add_pd(_mm_sub_pd(s, t), x);
+            const __m128d small = _mm_add_pd(_mm_sub_pd(x, t), s);
+            c = _mm_add_pd(c, _mm_or_pd(_mm_and_pd(ge, big), _mm_andnot_pd(ge, small)));
+            s = t;
+        }
+
+        KERNEL_TARGET("sse2") inline void reduce(NeumaierSum &acc, __m128d s, __m128d c)
+        {
+            alignas(16) double lanes[4];
+            _mm_store_pd(lanes, s);
+            _mm_store_pd(lanes + 2, c);
+            addLanes(acc, lanes, 4);
+        }
+
+        KERNEL_TARGET("sse2") double sum(const double *data, std::size_t size)
+        {
+            __m128d s = _mm_setzero_pd(), c = _mm_setzero_pd();
+            std::size_t i = 0;
+            for (; i + 2 <= size; i += 2)
+                neumaier(s, c, _mm_loadu_pd(data + i));
+
+            NeumaierSum acc;
+            reduce(acc, s, c);
+            for (; i < size; ++i)
+                acc.add(data[i]);
+            return acc.value();
+        }
+
+        KERNEL_TARGET("sse2") MinMax minMax(const double *data, std::size_t size)
+        {
+            if (size < 2)
+                return Scalar::minMax(data, size);
+
+            __m128d lo = _mm_loadu_pd(data), hi = lo;
+            std::size_t i = 2;
+            for (; i + 2 <= size; i += 2)
+            {
+                const __m128d x = _mm_loadu_pd(data + i);
+                lo = _mm_min_pd(lo, x);
+                hi = _mm_max_pd(hi, x);
+            }
+
+            alignas(16) double los[2], his[2];
+            _mm_store_pd(los, lo);
+            _mm_store_pd(his, hi);
+            const MinMax tail = Scalar::minMax(data + i, size - i);
+            return {std::min({los[0], los[1], tail.min}), std::max({his[0], his[1], tail.max})};
+        }
+
+        KERNEL_TARGET("sse2") PowerSums centralPowerSums(const double *data, std::size_t size, double center)
+        {
+            const __m128d c = _mm_set1_pd(center);
+            __m128d s1 = _mm_setzero_pd(), c1 = s1, s2 = s1, c2 = s1, s3 = s1, c3 = s1, s4 = s1, c4 = s1;
+            std::size_t i = 0;
+            for (; i + 2 <= size; i += 2)
+            {
+                const __m128d d = _mm_sub_pd(_mm_loadu_pd(data + i), c);
+                const __m128d d2 = _mm_mul_pd(d, d);
+                neumaier(s1, c1, d);
+                neumaier(s2, c2, d2);
+                neumaier(s3, c3, _mm_mul_pd(d2, d));
+                neumaier(s4, c4, _mm_mul_pd(d2, d2));
+            }
+
+            NeumaierSum a1, a2, a3, a4;
+            reduce(a1, s1, c1);
+            reduce(a2, s2, c2);
+            reduce(a3, s3, c3);
+            reduce(a4, s4, c4);
+            const PowerSums tail = Scalar::centralPowerSums(data + i, size - i, center);
+            a1.add(tail.s1);
+            a2.add(tail.s2);
+            a3.add(tail.s3);
+            a4.add(tail.s4);
+            return {a1.value(), a2.value(), a3.value(), a4.value()};
+        }
+
+        KERNEL_TARGET("sse2") double reciprocalSum(const double *data, std::size_t size)
+        {
+            const __m128d one = _mm_set1_pd(1.0);
+            __m128d s = _mm_setzero_pd(), c = _mm_setzero_pd();
+            std::size_t i = 0;
+            for (; i + 2 <= size; i += 2)
+                neumaier(s, c, _mm_div_pd(one, _mm_loadu_pd(data + i)));
+
+            NeumaierSum acc;
+            reduce(acc, s, c);
+            acc.add(Scalar::reciprocalSum(data + i, size - i));
+            return acc.value();
+        }
+
+        KERNEL_TARGET("sse2") double logSum(const double *data, std::size_t size)
+        {
+            const __m128i mantissaMask = _mm_set1_epi64x(MANTISSA_MASK);
+            const __m128i oneBits = _mm_set1_epi64x(ONE_BITS);
+            __m128d product = _mm_set1_pd(1.0);
+            __m128i exponents = _mm_setzero_si128();
+            std::int64_t biasCount = 0;
+            int steps = 0;
+
+            std::size_t i = 0;
+            for (; i + 2 <= size; i += 2)
+            {
+                const __m128i bits = _mm_castpd_si128(_mm_loadu_pd(data + i));
+                exponents = _mm_add_epi64(exponents, _mm_srli_epi64(bits, 52));
+                product = _mm_mul_pd(product, _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, mantissaMask), oneBits)));
+                ++biasCount;
+
+                if (++steps == RENORMALIZE_STEPS)
+                {
+                    const __m128i productBits = _mm_castpd_si128(product);
+                    exponents = _mm_add_epi64(exponents, _mm_srli_epi64(productBits, 52));
+                    product = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(productBits, mantissaMask), oneBits));
+                    ++biasCount;
+                    steps = 0;
+                }
+            }
+
+            alignas(16) double products[2];
+            alignas(16) std::int64_t lanes[2];
+            _mm_store_pd(products, product);
+            _mm_store_si128(reinterpret_cast<__m128i *>(lanes), exponents);
+            return finishLogSum(products, lanes, 2, biasCount, data + i, size - i);
+        }
+
+        KERNEL_TARGET("sse2") inline __m128d select(__m128d mask, __m128d a, __m128d b)
+        {
+            return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+        }
+
+        KERNEL_TARGET("sse2") inline __m128d horner(__m128d x, const double *c, int n)
+        {
+            __m128d result = _mm_set1_pd(c[0]);
+            for (int i = 1; i < n; ++i)
+                result = _mm_add_pd(_mm_mul_pd(result, x), _mm_set1_pd(c[i]));
+            return result;
+        }
+
+        KERNEL_TARGET("sse2") inline __m128d exp(__m128d y)
+        {
+            const __m128d underflow = _mm_cmplt_pd(y, _mm_set1_pd(EXP_MIN));
+            y = _mm_min_pd(_mm_max_pd(y, _mm_set1_pd(EXP_MIN)), _mm_set1_pd(EXP_MAX));
+            const __m128d kd = _mm_add_pd(_mm_mul_pd(y, _mm_set1_pd(LOG2E)), _mm_set1_pd(SHIFTER));
+            const __m128d k = _mm_sub_pd(kd, _mm_set1_pd(SHIFTER));
+            const __m128d r = _mm_sub_pd(_mm_sub_pd(y, _mm_mul_pd(k, _mm_set1_pd(LN2_HI))), _mm_mul_pd(k, _mm_set1_pd(LN2_LO)));
+            const __m128i scaleBits = _mm_slli_epi64(_mm_add_epi64(_mm_castpd_si128(kd), _mm_set1_epi64x(EXPONENT_BIAS)), 52);
+            const __m128d result = _mm_mul_pd(horner(r, EXP_TAYLOR, terms(EXP_TAYLOR)), _mm_castsi128_pd(scaleBits));
+            return _mm_andnot_pd(underflow, result);
+        }
+
+        KERNEL_TARGET("sse2") inline __m128d log(__m128d x)
+        {
+            const __m128i bits = _mm_castpd_si128(x);
+            const __m128d two52 = _mm_set1_pd(TWO52);
+            __m128d m = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(MANTISSA_MASK)), _mm_set1_epi64x(ONE_BITS)));
+            __m128d e = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(bits, 52), _mm_castpd_si128(two52))), two52);
+            e = _mm_sub_pd(e, _mm_set1_pd(EXPONENT_BIAS));
+            const __m128d high = _mm_cmpgt_pd(m, _mm_set1_pd(SQRT2));
+            m = select(high, _mm_mul_pd(m, _mm_set1_pd(0.5)), m);
+            e = _mm_add_pd(e, _mm_and_pd(high, _mm_set1_pd(1.0)));
+            const __m128d one = _mm_set1_pd(1.0);
+            const __m128d s = _mm_div_pd(_mm_sub_pd(m, one), _mm_add_pd(m, one));
+            const __m128d series = _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(2.0), s), horner(_mm_mul_pd(s, s), LOG_SERIES, terms(LOG_SERIES)));
+            return _mm_add_pd(_mm_mul_pd(e, _mm_set1_pd(LN2_HI)), _mm_add_pd(series, _mm_mul_pd(e, _mm_set1_pd(LN2_LO))));
+        }
+
+        KERNEL_TARGET("sse2") inline __m128d tail(__m128d x)
+        {
+            const __m128d ax = _mm_min_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), x), _mm_set1_pd(CDF_MAX_ABS));
+            const __m128d two = _mm_set1_pd(2.0);
+            const __m128d t = _mm_div_pd(two, _mm_add_pd(two, _mm_mul_pd(ax, _mm_set1_pd(SQRT1_2))));
+            const __m128d u = _mm_sub_pd(_mm_mul_pd(two, t), _mm_set1_pd(1.0));
+            const __m128d u2 = _mm_mul_pd(u, u);
+            const __m128d f = _mm_add_pd(horner(u2, ERFC_EVEN, terms(ERFC_EVEN)), _mm_mul_pd(u, horner(u2, ERFC_ODD, terms(ERFC_ODD))));
+
+            const __m128d c = _mm_mul_pd(_mm_set1_pd(SPLITTER), ax);
+            const __m128d xh = _mm_sub_pd(c, _mm_sub_pd(c, ax));
+            const __m128d xl = _mm_sub_pd(ax, xh);
+            const __m128d hi = _mm_mul_pd(ax, ax);
+            const __m128d lo = _mm_add_pd(_mm_add_pd(_mm_sub_pd(_mm_mul_pd(xh, xh), hi), _mm_mul_pd(_mm_mul_pd(two, xh), xl)), _mm_mul_pd(xl, xl));
+
+            const __m128d half = _mm_set1_pd(0.5);
+            const __m128d a = _mm_mul_pd(_mm_set1_pd(-0.5), hi);
+            const __m128d b = _mm_sub_pd(f, _mm_mul_pd(half, lo));
+            const __m128d y = _mm_add_pd(a, b);
+            const __m128d bb = _mm_sub_pd(y, a);
+            const __m128d err = _mm_add_pd(_mm_sub_pd(a, _mm_sub_pd(y, bb)), _mm_sub_pd(b, bb));
+            return _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(half, t), exp(y)), _mm_add_pd(_mm_set1_pd(1.0), err));
+        }
+
+        KERNEL_TARGET("sse2") void normalCdf(const double *in, double *out, std::size_t size)
+        {
+            std::size_t i = 0;
+            for (; i + 2 <= size; i += 2)
+            {
+                const __m128d x = _mm_loadu_pd(in + i);
+                const __m128d h = tail(x);
+                const __m128d result = select(_mm_cmplt_pd(x, _mm_setzero_pd()), h, _mm_sub_pd(_mm_set1_pd(1.0), h));
+                _mm_storeu_pd(out + i, select(_mm_cmpord_pd(x, x), result, x));
+            }
+            Scalar::normalCdf(in + i, out + i, size - i);
+        }
+
+        KERNEL_TARGET("sse2") void normalQuantile(const double *in, double *out, std::size_t size)
+        {
+            const __m128d one = _mm_set1_pd(1.0);
+            const __m128d half = _mm_set1_pd(0.5);
+            std::size_t i = 0;
+            for (; i + 2 <= size; i += 2)
+            {
+                const __m128d p = _mm_loadu_pd(in + i);
+                const __m128d pp = _mm_min_pd(p, _mm_sub_pd(one, p));
+
+                const __m128d q = _mm_sub_pd(pp, half);
+                const __m128d r = _mm_mul_pd(q, q);
+                const __m128d central = _mm_div_pd(_mm_mul_pd(horner(r, ACKLAM_A, terms(ACKLAM_A)), q), horner(r, ACKLAM_B, terms(ACKLAM_B)));
+                const __m128d qt = _mm_sqrt_pd(_mm_mul_pd(_mm_set1_pd(-2.0), log(_mm_max_pd(pp, _mm_set1_pd(DBL_MIN_NORMAL)))));
+                const __m128d lower = _mm_div_pd(horner(qt, ACKLAM_C, terms(ACKLAM_C)), horner(qt, ACKLAM_D, terms(ACKLAM_D)));
+                __m128d x = select(_mm_cmplt_pd(pp, _mm_set1_pd(ACKLAM_P_LOW)), lower, central);
+
+                const __m128d y = _mm_mul_pd(x, _mm_set1_pd(SQRT1_2));
+                const __m128d halfErf = _mm_mul_pd(_mm_mul_pd(y, _mm_set1_pd(INV_SQRT_PI)), horner(_mm_mul_pd(y, y), ERF_SERIES, terms(ERF_SERIES)));
+                const __m128d nearMedian = _mm_cmplt_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), x), half);
+                const __m128d e = select(nearMedian, _mm_sub_pd(halfErf, q), _mm_sub_pd(tail(x), pp));
+                const __m128d u = _mm_mul_pd(_mm_mul_pd(e, _mm_set1_pd(SQRT_2PI)), exp(_mm_mul_pd(half, _mm_mul_pd(x, x))));
+                x = _mm_sub_pd(x, _mm_div_pd(u, _mm_add_pd(one, _mm_mul_pd(_mm_mul_pd(half, x), u))));
+
+                const __m128d valid = _mm_and_pd(_mm_cmpgt_pd(p, _mm_setzero_pd()), _mm_cmplt_pd(p, one));
+                x = select(_mm_cmpgt_pd(p, half), _mm_sub_pd(_mm_setzero_pd(), x), x);
+                _mm_storeu_pd(out + i, select(valid, x, _mm_set1_pd(std::numeric_limits<double>::quiet_NaN())));
+            }
+            Scalar::normalQuantile(in + i, out + i, size - i);
+        }
+    }
+
+    namespace Avx2
+    {
+        KERNEL_TARGET("avx2") inline void neumaier(__m256d &s, __m256d &c, __m256d x)
+        {
+            const __m256d signMask = _mm256_set1_pd(-0.0);
+            const __m256d t = _mm256_add_pd(s, x);
+            const __m256d ge = _mm256_cmp_pd(_mm256_andnot_pd(signMask, s), _mm256_andnot_pd(signMask, x), _CMP_GE_OQ);
+            const __m256d big = _mm256_add_pd(_mm256_sub_pd(s, t), x);
+            const __m256d small = _mm256_add_pd(_mm256_sub_pd(x, t), s);
+            c = _mm256_add_pd(c, _mm256_blendv_pd(small, big, ge));
+            s = t;
+        }
+
+        KERNEL_TARGET("avx2") inline void reduce(NeumaierSum &acc, __m256d s, __m256d c)
+        {
+            alignas(32) double lanes[8];
+            _mm256_store_pd(lanes, s);
+            _mm256_store_pd(lanes + 4, c);
+            addLanes(acc, lanes, 8);
+        }
+
+        KERNEL_TARGET("avx2") double sum(const double *data, std::size_t size)
+        {
+            __m256d s = _mm256_setzero_pd(), c = _mm256_setzero_pd();
+            std::size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+                neumaier(s, c, _mm256_loadu_pd(data + i));
+
+            NeumaierSum acc;
+            reduce(acc, s, c);
+            for (; i < size; ++i)
+                acc.add(data[i]);
+            return acc.value();
+        }
+
+        KERNEL_TARGET("avx2") MinMax minMax(const double *data, std::size_t size)
+        {
+            if (size < 4)
+                return Scalar::minMax(data, size);
+
+            __m256d lo = _mm256_loadu_pd(data), hi = lo;
+            std::size_t i = 4;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m256d x = _mm256_loadu_pd(data + i);
+                lo = _mm256_min_pd(lo, x);
+                hi = _mm256_max_pd(hi, x);
+            }
+
+            alignas(32) double los[4], his[4];
+            _mm256_store_pd(los, lo);
+            _mm256_store_pd(his, hi);
+            MinMax result = Scalar::minMax(data + i, size - i);
+            result.min = std::min(result.min, *std::min_element(los, los + 4));
+            result.max = std::max(result.max, *std::max_element(his, his + 4));
+            return result;
+        }
+
+        KERNEL_TARGET("avx2") PowerSums centralPowerSums(const double *data, std::size_t size, double center)
+        {
+            const __m256d c = _mm256_set1_pd(center);
+            __m256d s1 = _mm256_setzero_pd(), c1 = s1, s2 = s1, c2 = s1, s3 = s1, c3 = s1, s4 = s1, c4 = s1;
+            std::size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m256d d = _mm256_sub_pd(_mm256_loadu_pd(data + i), c);
+                const __m256d d2 = _mm256_mul_pd(d, d);
+                neumaier(s1, c1, d);
+                neumaier(s2, c2, d2);
+                neumaier(s3, c3, _mm256_mul_pd(d2, d));
+                neumaier(s4, c4, _mm256_mul_pd(d2, d2));
+            }
+
+            NeumaierSum a1, a2, a3, a4;
+            reduce(a1, s1, c1);
+            reduce(a2, s2, c2);
+            reduce(a3, s3, c3);
+            reduce(a4, s4, c4);
+            const PowerSums tail = Scalar::centralPowerSums(data + i, size - i, center);
+            a1.add(tail.s1);
+            a2.add(tail.s2);
+            a3.add(tail.s3);
+            a4.add(tail.s4);
+            return {a1.value(), a2.value(), a3.value(), a4.value()};
+        }
+
+        KERNEL_TARGET("avx2") double reciprocalSum(const double *data, std::size_t size)
+        {
+            const __m256d one = _mm256_set1_pd(1.0);
+            __m256d s = _mm256_setzero_pd(), c = _mm256_setzero_pd();
+            std::size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+                neumaier(s, c, _mm256_div_pd(one, _mm256_loadu_pd(data + i)));
+
+            NeumaierSum acc;
+            reduce(acc, s, c);
+            acc.add(Scalar::reciprocalSum(data + i, size - i));
+            return acc.value();
+        }
+
+        KERNEL_TARGET("avx2") double logSum(const double *data, std::size_t size)
+        {
+            const __m256i mantissaMask = _mm256_set1_epi64x(MANTISSA_MASK);
+            const __m256i oneBits = _mm256_set1_epi64x(ONE_BITS);
+            __m256d product = _mm256_set1_pd(1.0);
+            __m256i exponents = _mm256_setzero_si256();
+            std::int64_t biasCount = 0;
+            int steps = 0;
+
+            std::size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m256i bits = _mm256_castpd_si256(_mm256_loadu_pd(data + i));
+                exponents = _mm256_add_epi64(exponents, _mm256_srli_epi64(bits, 52));
+                product = _mm256_mul_pd(product, _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, mantissaMask), oneBits)));
+                ++biasCount;
+
+                if (++steps == RENORMALIZE_STEPS)
+                {
+                    const __m256i productBits = _mm256_castpd_si256(product);
+                    exponents = _mm256_add_epi64(exponents, _mm256_srli_epi64(productBits, 52));
+                    product = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(productBits, mantissaMask), oneBits));
+                    ++biasCount;
+                    steps = 0;
+                }
+            }
+
+            alignas(32) double products[4];
+            alignas(32) std::int64_t lanes[4];
+            _mm256_store_pd(products, product);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), exponents);
+            return finishLogSum(products, lanes, 4, biasCount, data + i, size - i);
+        }
+
+        KERNEL_TARGET("avx2") inline __m256d select(__m256d mask, __m256d a, __m256d b)
+        {
+            return _mm256_blendv_pd(b, a, mask);
+        }
+
+        KERNEL_TARGET("avx2") inline __m256d horner(__m256d x, const double *c, int n)
+        {
+            __m256d result = _mm256_set1_pd(c[0]);
+            for (int i = 1; i < n; ++i)
+                result = _mm256_add_pd(_mm256_mul_pd(result, x), _mm256_set1_pd(c[i]));
+            return result;
+        }
+
+        KERNEL_TARGET("avx2") inline __m256d exp(__m256d y)
+        {
+            const __m256d underflow = _mm256_cmp_pd(y, _mm256_set1_pd(EXP_MIN), _CMP_LT_OQ);
+            y = _mm256_min_pd(_mm256_max_pd(y, _mm256_set1_pd(EXP_MIN)), _mm256_set1_pd(EXP_MAX));
+            const __m256d kd = _mm256_add_pd(_mm256_mul_pd(y, _mm256_set1_pd(LOG2E)), _mm256_set1_pd(SHIFTER));
+            const __m256d k = _mm256_sub_pd(kd, _mm256_set1_pd(SHIFTER));
+            const __m256d r = _mm256_sub_pd(_mm256_sub_pd(y, _mm256_mul_pd(k, _mm256_set1_pd(LN2_HI))), _mm256_mul_pd(k, _mm256_set1_pd(LN2_LO)));
+            const __m256i scaleBits = _mm256_slli_epi64(_mm256_add_epi64(_mm256_castpd_si256(kd), _mm256_set1_epi64x(EXPONENT_BIAS)), 52);
+            const __m256d result = _mm256_mul_pd(horner(r, EXP_TAYLOR, terms(EXP_TAYLOR)), _mm256_castsi256_pd(scaleBits));
+            return _mm256_andnot_pd(underflow, result);
+        }
+
+        KERNEL_TARGET("avx2") inline __m256d log(__m256d x)
+        {
+            const __m256i bits = _mm256_castpd_si256(x);
+            const __m256d two52 = _mm256_set1_pd(TWO52);
+            __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(MANTISSA_MASK)), _mm256_set1_epi64x(ONE_BITS)));
+            __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(two52))), two52);
+            e = _mm256_sub_pd(e, _mm256_set1_pd(EXPONENT_BIAS));
+            const __m256d high = _mm256_cmp_pd(m, _mm256_set1_pd(SQRT2), _CMP_GT_OQ);
+            m = select(high, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), m);
+            e = _mm256_add_pd(e, _mm256_and_pd(high, _mm256_set1_pd(1.0)));
+            const __m256d one = _mm256_set1_pd(1.0);
+            const __m256d s = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+            const __m256d series = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), s), horner(_mm256_mul_pd(s, s), LOG_SERIES, terms(LOG_SERIES)));
+            return _mm256_add_pd(_mm256_mul_pd(e, _mm256_set1_pd(LN2_HI)), _mm256_add_pd(series, _mm256_mul_pd(e, _mm256_set1_pd(LN2_LO))));
+        }
+
+        KERNEL_TARGET("avx2") inline __m256d tail(__m256d x)
+        {
+            const __m256d ax = _mm256_min_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), x), _mm256_set1_pd(CDF_MAX_ABS));
+            const __m256d two = _mm256_set1_pd(2.0);
+            const __m256d t = _mm256_div_pd(two, _mm256_add_pd(two, _mm256_mul_pd(ax, _mm256_set1_pd(SQRT1_2))));
+            const __m256d u = _mm256_sub_pd(_mm256_mul_pd(two, t), _mm256_set1_pd(1.0));
+            const __m256d u2 = _mm256_mul_pd(u, u);
+            const __m256d f = _mm256_add_pd(horner(u2, ERFC_EVEN, terms(ERFC_EVEN)), _mm256_mul_pd(u, horner(u2, ERFC_ODD, terms(ERFC_ODD))));
+
+            const __m256d c = _mm256_mul_pd(_mm256_set1_pd(SPLITTER), ax);
+            const __m256d xh = _mm256_sub_pd(c, _mm256_sub_pd(c, ax));
+            const __m256d xl = _mm256_sub_pd(ax, xh);
+            const __m256d hi = _mm256_mul_pd(ax, ax);
+            const __m256d lo = _mm256_add_pd(_mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(xh, xh), hi), _mm256_mul_pd(_mm256_mul_pd(two, xh), xl)), _mm256_mul_pd(xl, xl));
+
+            const __m256d half = _mm256_set1_pd(0.5);
+            const __m256d a = _mm256_mul_pd(_mm256_set1_pd(-0.5), hi);
+            const __m256d b = _mm256_sub_pd(f, _mm256_mul_pd(half, lo));
+            const __m256d y = _mm256_add_pd(a, b);
+            const __m256d bb = _mm256_sub_pd(y, a);
+            const __m256d err = _mm256_add_pd(_mm256_sub_pd(a, _mm256_sub_pd(y, bb)), _mm256_sub_pd(b, bb));
+            return _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(half, t), exp(y)), _mm256_add_pd(_mm256_set1_pd(1.0), err));
+        }
+
+        KERNEL_TARGET("avx2") void normalCdf(const double *in, double *out, std::size_t size)
+        {
+            std::size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m256d x = _mm256_loadu_pd(in + i);
+                const __m256d h = tail(x);
+                const __m256d result = select(_mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_LT_OQ), h, _mm256_sub_pd(_mm256_set1_pd(1.0), h));
+                _mm256_storeu_pd(out + i, select(_mm256_cmp_pd(x, x, _CMP_ORD_Q), result, x));
+            }
+            Scalar::normalCdf(in + i, out + i, size - i);
+        }
+
+        KERNEL_TARGET("avx2") void normalQuantile(const double *in, double *out, std::size_t size)
+        {
+            const __m256d one = _mm256_set1_pd(1.0);
+            const __m256d half = _mm256_set1_pd(0.5);
+            std::size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                const __m256d p = _mm256_loadu_pd(in + i);
+                const __m256d pp = _mm256_min_pd(p, _mm256_sub_pd(one, p));
+
+                const __m256d q = _mm256_sub_pd(pp, half);
+                const __m256d r = _mm256_mul_pd(q, q);
+                const __m256d central = _mm256_div_pd(_mm256_mul_pd(horner(r, ACKLAM_A, terms(ACKLAM_A)), q), horner(r, ACKLAM_B, terms(ACKLAM_B)));
+                const __m256d qt = _mm256_sqrt_pd(_mm256_mul_pd(_mm256_set1_pd(-2.0), log(_mm256_max_pd(pp, _mm256_set1_pd(DBL_MIN_NORMAL)))));
+                const __m256d lower = _mm256_div_pd(horner(qt, ACKLAM_C, terms(ACKLAM_C)), horner(qt, ACKLAM_D, terms(ACKLAM_D)));
+                __m256d x = select(_mm256_cmp_pd(pp, _mm256_set1_pd(ACKLAM_P_LOW), _CMP_LT_OQ), lower, central);
+
+                const __m256d y = _mm256_mul_pd(x, _mm256_set1_pd(SQRT1_2));
+                const __m256d halfErf = _mm256_mul_pd(_mm256_mul_pd(y, _mm256_set1_pd(INV_SQRT_PI)), horner(_mm256_mul_pd(y, y), ERF_SERIES, terms(ERF_SERIES)));
+                const __m256d nearMedian = _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), x), half, _CMP_LT_OQ);
+                const __m256d e = select(nearMedian, _mm256_sub_pd(halfErf, q), _mm256_sub_pd(tail(x), pp));
+                const __m256d u = _mm256_mul_pd(_mm256_mul_pd(e, _mm256_set1_pd(SQRT_2PI)), exp(_mm256_mul_pd(half, _mm256_mul_pd(x, x))));
+                x = _mm256_sub_pd(x, _mm256_div_pd(u, _mm256_add_pd(one, _mm256_mul_pd(_mm256_mul_pd(half, x), u))));
+
+                const __m256d valid = _mm256_and_pd(_mm256_cmp_pd(p, _mm256_setzero_pd(), _CMP_GT_OQ), _mm256_cmp_pd(p, one, _CMP_LT_OQ));
+                x = select(_mm256_cmp_pd(p, half, _CMP_GT_OQ), _mm256_sub_pd(_mm256_setzero_pd(), x), x);
+                _mm256_storeu_pd(out + i, select(valid, x, _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN())));
+            }
+            Scalar::normalQuantile(in + i, out + i, size - i);
+        }
+    }
+
+    namespace Avx512
+    {
+        KERNEL_TARGET("avx512f") inline void neumaier(__m512d &s, __m512d &c, __m512d x)
+        {
+            const __m512d t = _mm512_add_pd(s, x);
+            const __mmask8 ge = _mm512_cmp_pd_mask(_mm512_abs_pd(s), _mm512_abs_pd(x), _CMP_GE_OQ);
+            const __m512d big = _mm512_add_pd(_mm512_sub_pd(s, t), x);
+            const __m512d small = _mm512_add_pd(_mm512_sub_pd(x, t), s);
+            c = _mm512_add_pd(c, _mm512_mask_blend_pd(ge, small, big));
+            s = t;
+        }
+
+        KERNEL_TARGET("avx512f") inline void reduce(NeumaierSum &acc, __m512d s, __m512d c)
+        {
+            alignas(64) double lanes[16];
+            _mm512_store_pd(lanes, s);
+            _mm512_store_pd(lanes + 8, c);
+            addLanes(acc, lanes, 16);
+        }
+
+        KERNEL_TARGET("avx512f") double sum(const double *data, std::size_t size)
+        {
+            __m512d s = _mm512_setzero_pd(), c = _mm512_setzero_pd();
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+                neumaier(s, c, _mm512_loadu_pd(data + i));
+
+            NeumaierSum acc;
+            reduce(acc, s, c);
+            for (; i < size; ++i)
+                acc.add(data[i]);
+            return acc.value();
+        }
+
+        KERNEL_TARGET("avx512f") MinMax minMax(const double *data, std::size_t size)
+        {
+            if (size < 8)
+                return Scalar::minMax(data, size);
+
+            __m512d lo = _mm512_loadu_pd(data), hi = lo;
+            std::size_t i = 8;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m512d x = _mm512_loadu_pd(data + i);
+                lo = _mm512_min_pd(lo, x);
+                hi = _mm512_max_pd(hi, x);
+            }
+
+            MinMax result = Scalar::minMax(data + i, size - i);
+            result.min = std::min(result.min, _mm512_reduce_min_pd(lo));
+            result.max = std::max(result.max, _mm512_reduce_max_pd(hi));
+            return result;
+        }
+
+        KERNEL_TARGET("avx512f") PowerSums centralPowerSums(const double *data, std::size_t size, double center)
+        {
+            const __m512d c = _mm512_set1_pd(center);
+            __m512d s1 = _mm512_setzero_pd(), c1 = s1, s2 = s1, c2 = s1, s3 = s1, c3 = s1, s4 = s1, c4 = s1;
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m512d d = _mm512_sub_pd(_mm512_loadu_pd(data + i), c);
+                const __m512d d2 = _mm512_mul_pd(d, d);
+                neumaier(s1, c1, d);
+                neumaier(s2, c2, d2);
+                neumaier(s3, c3, _mm512_mul_pd(d2, d));
+                neumaier(s4, c4, _mm512_mul_pd(d2, d2));
+            }
+
+            NeumaierSum a1, a2, a3, a4;
+            reduce(a1, s1, c1);
+            reduce(a2, s2, c2);
+            reduce(a3, s3, c3);
+            reduce(a4, s4, c4);
+            const PowerSums tail = Scalar::centralPowerSums(data + i, size - i, center);
+            a1.add(tail.s1);
+            a2.add(tail.s2);
+            a3.add(tail.s3);
+            a4.add(tail.s4);
+            return {a1.value(), a2.value(), a3.value(), a4.value()};
+        }
+
+        KERNEL_TARGET("avx512f") double reciprocalSum(const double *data, std::size_t size)
+        {
+            const __m512d one = _mm512_set1_pd(1.0);
+            __m512d s = _mm512_setzero_pd(), c = _mm512_setzero_pd();
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+                neumaier(s, c, _mm512_div_pd(one, _mm512_loadu_pd(data + i)));
+
+            NeumaierSum acc;
+            reduce(acc, s, c);
+            acc.add(Scalar::reciprocalSum(data + i, size - i));
+            return acc.value();
+        }
+
+        KERNEL_TARGET("avx512f") double logSum(const double *data, std::size_t size)
+        {
+            const __m512i mantissaMask = _mm512_set1_epi64(MANTISSA_MASK);
+            const __m512i oneBits = _mm512_set1_epi64(ONE_BITS);
+            __m512d product = _mm512_set1_pd(1.0);
+            __m512i exponents = _mm512_setzero_si512();
+            std::int64_t biasCount = 0;
+            int steps = 0;
+
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m512i bits = _mm512_castpd_si512(_mm512_loadu_pd(data + i));
+                exponents = _mm512_add_epi64(exponents, _mm512_srli_epi64(bits, 52));
+                product = _mm512_mul_pd(product, _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(bits, mantissaMask), oneBits)));
+                ++biasCount;
+
+                if (++steps == RENORMALIZE_STEPS)
+                {
+                    const __m512i productBits = _mm512_castpd_si512(product);
+                    exponents = _mm512_add_epi64(exponents, _mm512_srli_epi64(productBits, 52));
+                    product = _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(productBits, mantissaMask), oneBits));
+                    ++biasCount;
+                    steps = 0;
+                }
+            }
+
+            alignas(64) double products[8];
+            alignas(64) std::int64_t lanes[8];
+            _mm512_store_pd(products, product);
+            _mm512_store_si512(lanes, exponents);
+            return finishLogSum(products, lanes, 8, biasCount, data + i, size - i);
+        }
+
+        KERNEL_TARGET("avx512f") inline __m512d select(__mmask8 mask, __m512d a, __m512d b)
+        {
+            return _mm512_mask_blend_pd(mask, b, a);
+        }
+
+        KERNEL_TARGET("avx512f") inline __m512d horner(__m512d x, const double *c, int n)
+        {
+            __m512d result = _mm512_set1_pd(c[0]);
+            for (int i = 1; i < n; ++i)
+                result = _mm512_add_pd(_mm512_mul_pd(result, x), _mm512_set1_pd(c[i]));
+            return result;
+        }
+
+        KERNEL_TARGET("avx512f") inline __m512d exp(__m512d y)
+        {
+            const __mmask8 underflow = _mm512_cmp_pd_mask(y, _mm512_set1_pd(EXP_MIN), _CMP_LT_OQ);
+            y = _mm512_min_pd(_mm512_max_pd(y, _mm512_set1_pd(EXP_MIN)), _mm512_set1_pd(EXP_MAX));
+            const __m512d kd = _mm512_add_pd(_mm512_mul_pd(y, _mm512_set1_pd(LOG2E)), _mm512_set1_pd(SHIFTER));
+            const __m512d k = _mm512_sub_pd(kd, _mm512_set1_pd(SHIFTER));
+            const __m512d r = _mm512_sub_pd(_mm512_sub_pd(y, _mm512_mul_pd(k, _mm512_set1_pd(LN2_HI))), _mm512_mul_pd(k, _mm512_set1_pd(LN2_LO)));
+            const __m512i scaleBits = _mm512_slli_epi64(_mm512_add_epi64(_mm512_castpd_si512(kd), _mm512_set1_epi64(EXPONENT_BIAS)), 52);
+            const __m512d result = _mm512_mul_pd(horner(r, EXP_TAYLOR, terms(EXP_TAYLOR)), _mm512_castsi512_pd(scaleBits));
+            return _mm512_maskz_mov_pd(static_cast<__mmask8>(~underflow), result);
+        }
+
+        KERNEL_TARGET("avx512f") inline __m512d log(__m512d x)
+        {
+            const __m512i bits = _mm512_castpd_si512(x);
+            const __m512d two52 = _mm512_set1_pd(TWO52);
+            __m512d m = _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi64(MANTISSA_MASK)), _mm512_set1_epi64(ONE_BITS)));
+            __m512d e = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(bits, 52), _mm512_castpd_si512(two52))), two52);
+            e = _mm512_sub_pd(e, _mm512_set1_pd(EXPONENT_BIAS));
+            const __mmask8 high = _mm512_cmp_pd_mask(m, _mm512_set1_pd(SQRT2), _CMP_GT_OQ);
+            m = select(high, _mm512_mul_pd(m, _mm512_set1_pd(0.5)), m);
+            e = _mm512_mask_add_pd(e, high, e, _mm512_set1_pd(1.0));
+            const __m512d one = _mm512_set1_pd(1.0);
+            const __m512d s = _mm512_div_pd(_mm512_sub_pd(m, one), _mm512_add_pd(m, one));
+            const __m512d series = _mm512_mul_pd(_mm512_mul_pd(_mm512_set1_pd(2.0), s), horner(_mm512_mul_pd(s, s), LOG_SERIES, terms(LOG_SERIES)));
+            return _mm512_add_pd(_mm512_mul_pd(e, _mm512_set1_pd(LN2_HI)), _mm512_add_pd(series, _mm512_mul_pd(e, _mm512_set1_pd(LN2_LO))));
+        }
+
+        KERNEL_TARGET("avx512f") inline __m512d tail(__m512d x)
+        {
+            const __m512d ax = _mm512_min_pd(_mm512_abs_pd(x), _mm512_set1_pd(CDF_MAX_ABS));
+            const __m512d two = _mm512_set1_pd(2.0);
+            const __m512d t = _mm512_div_pd(two, _mm512_add_pd(two, _mm512_mul_pd(ax, _mm512_set1_pd(SQRT1_2))));
+            const __m512d u = _mm512_sub_pd(_mm512_mul_pd(two, t), _mm512_set1_pd(1.0));
+            const __m512d u2 = _mm512_mul_pd(u, u);
+            const __m512d f = _mm512_add_pd(horner(u2, ERFC_EVEN, terms(ERFC_EVEN)), _mm512_mul_pd(u, horner(u2, ERFC_ODD, terms(ERFC_ODD))));
+
+            const __m512d c = _mm512_mul_pd(_mm512_set1_pd(SPLITTER), ax);
+            const __m512d xh = _mm512_sub_pd(c, _mm512_sub_pd(c, ax));
+            const __m512d xl = _mm512_sub_pd(ax, xh);
+            const __m512d hi = _mm512_mul_pd(ax, ax);
+            const __m512d lo = _mm512_add_pd(_mm512_add_pd(_mm512_sub_pd(_mm512_mul_pd(xh, xh), hi), _mm512_mul_pd(_mm512_mul_pd(two, xh), xl)), _mm512_mul_pd(xl, xl));
+
+            const __m512d half = _mm512_set1_pd(0.5);
+            const __m512d a = _mm512_mul_pd(_mm512_set1_pd(-0.5), hi);
+            const __m512d b = _mm512_sub_pd(f, _mm512_mul_pd(half, lo));
+            const __m512d y = _mm512_add_pd(a, b);
+            const __m512d bb = _mm512_sub_pd(y, a);
+            const __m512d err = _mm512_add_pd(_mm512_sub_pd(a, _mm512_sub_pd(y, bb)), _mm512_sub_pd(b, bb));
+            return _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(half, t), exp(y)), _mm512_add_pd(_mm512_set1_pd(1.0), err));
+        }
+
+        KERNEL_TARGET("avx512f") void normalCdf(const double *in, double *out, std::size_t size)
+        {
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m512d x = _mm512_loadu_pd(in + i);
+                const __m512d h = tail(x);
+                const __m512d result = select(_mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_LT_OQ), h, _mm512_sub_pd(_mm512_set1_pd(1.0), h));
+                _mm512_storeu_pd(out + i, select(_mm512_cmp_pd_mask(x, x, _CMP_ORD_Q), result, x));
+            }
+            Scalar::normalCdf(in + i, out + i, size - i);
+        }
+
+        KERNEL_TARGET("avx512f") void normalQuantile(const double *in, double *out, std::size_t size)
+        {
+            const __m512d one = _mm512_set1_pd(1.0);
+            const __m512d half = _mm512_set1_pd(0.5);
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                const __m512d p = _mm512_loadu_pd(in + i);
+                const __m512d pp = _mm512_min_pd(p, _mm512_sub_pd(one, p));
+
+                const __m512d q = _mm512_sub_pd(pp, half);
+                const __m512d r = _mm512_mul_pd(q, q);
+                const __m512d central = _mm512_div_pd(_mm512_mul_pd(horner(r, ACKLAM_A, terms(ACKLAM_A)), q), horner(r, ACKLAM_B, terms(ACKLAM_B)));
+                const __m512d qt = _mm512_sqrt_pd(_mm512_mul_pd(_mm512_set1_pd(-2.0), log(_mm512_max_pd(pp, _mm512_set1_pd(DBL_MIN_NORMAL)))));
+                const __m512d lower = _mm512_div_pd(horner(qt, ACKLAM_C, terms(ACKLAM_C)), horner(qt, ACKLAM_D, terms(ACKLAM_D)));
+                __m512d x = select(_mm512_cmp_pd_mask(pp, _mm512_set1_pd(ACKLAM_P_LOW), _CMP_LT_OQ), lower, central);
+
+                const __m512d y = _mm512_mul_pd(x, _mm512_set1_pd(SQRT1_2));
+                const __m512d halfErf = _mm512_mul_pd(_mm512_mul_pd(y, _mm512_set1_pd(INV_SQRT_PI)), horner(_mm512_mul_pd(y, y), ERF_SERIES, terms(ERF_SERIES)));
+                const __mmask8 nearMedian = _mm512_cmp_pd_mask(_mm512_abs_pd(x), half, _CMP_LT_OQ);
+                const __m512d e = select(nearMedian, _mm512_sub_pd(halfErf, q), _mm512_sub_pd(tail(x), pp));
+                const __m512d u = _mm512_mul_pd(_mm512_mul_pd(e, _mm512_set1_pd(SQRT_2PI)), exp(_mm512_mul_pd(half, _mm512_mul_pd(x, x))));
+                x = _mm512_sub_pd(x, _mm512_div_pd(u, _mm512_add_pd(one, _mm512_mul_pd(_mm512_mul_pd(half, x), u))));
+
+                const __mmask8 valid = _mm512_cmp_pd_mask(p, _mm512_setzero_pd(), _CMP_GT_OQ) & _mm512_cmp_pd_mask(p, one, _CMP_LT_OQ);
+                x = select(_mm512_cmp_pd_mask(p, half, _CMP_GT_OQ), _mm512_sub_pd(_mm512_setzero_pd(), x), x);
+                _mm512_storeu_pd(out + i, select(valid, x, _mm512_set1_pd(std::numeric_limits<double>::quiet_NaN())));
+            }
+            Scalar::normalQuantile(in + i, out + i, size - i);
+        }
+    }
+#endif
+
+    struct KernelTable
+    {
+        Isa isa;
+        double (*sum)(const double *, std::size_t);
+        MinMax (*minMax)(const double *, std::size_t);
+        PowerSums (*centralPowerSums)(const double *, std::size_t, double);
+        double (*reciprocalSum)(const double *, std::size_t);
+        double (*logSum)(const double *, std::size_t);
+        void (*normalCdf)(const double *, double *, std::size_t);
+        void (*normalQuantile)(const double *, double *, std::size_t);
+    };
+
+    const KernelTable scalarTable{Isa::Scalar, Scalar::sum, Scalar::minMax, Scalar::centralPowerSums,
+                                  Scalar::reciprocalSum, Scalar::logSum,
+                                  Scalar::normalCdf, Scalar::normalQuantile};
+#ifdef KERNELS_X86
+    const KernelTable sse2Table{Isa::Sse2, Sse2::sum, Sse2::minMax, Sse2::centralPowerSums,
+                                Sse2::reciprocalSum, Sse2::logSum,
+                                Sse2::normalCdf, Sse2::normalQuantile};
+    const KernelTable avx2Table{Isa::Avx2, Avx2::sum, Avx2::minMax, Avx2::centralPowerSums,
+                                Avx2::reciprocalSum, Avx2::logSum,
+                                Avx2::normalCdf, Avx2::normalQuantile};
+    const KernelTable avx512Table{Isa::Avx512, Avx512::sum, Avx512::minMax, Avx512::centralPowerSums,
+                                  Avx512::reciprocalSum, Avx512::logSum,
+                                  Avx512::normalCdf, Avx512::normalQuantile};
+#endif
+
+    const KernelTable *tableFor(Isa isa)
+    {
+        switch (isa)
+        {
+#ifdef KERNELS_X86
+        case Isa::Avx512: return &avx512Table;
+        case Isa::Avx2: return &avx2Table;
+        case Isa::Sse2: return &sse2Table;
+#endif
+        default: return &scalarTable;
+        }
+    }
+
+    Isa detectIsa()
+    {
+#if defined(KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return Isa::Avx512;
+        if (__builtin_cpu_supports("avx2"))
+            return Isa::Avx2;
+        return Isa::Sse2;
+#elif defined(KERNELS_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            const bool avx2 = (info[1] & (1 << 5)) != 0;
+            const bool avx512f = (info[1] & (1 << 16)) != 0;
+            // ОС должна сохранять регистры YMM (биты 1-2) и ZMM (биты 5-7)
+            if (avx512f && (xcr0 & 0xE6) == 0xE6)
+                return Isa::Avx512;
+            if (avx2 && (xcr0 & 0x6) == 0x6)
+                return Isa::Avx2;
+        }
+        return Isa::Sse2;
+#else
+        return Isa::Scalar;
+#endif
+    }
+
+    std::atomic<const KernelTable *> activeTable{nullptr};
+
+    const KernelTable &table()
+    {
+        const KernelTable *current = activeTable.load(std::memory_order_acquire);
+        if (!current)
+        {
+            current = tableFor(detectIsa());
+            activeTable.store(current, std::memory_order_release);
+        }
+        return *current;
+    }
+
+    Isa activeIsa()
+    {
+        return table().isa;
+    }
+
+    bool setIsa(Isa isa)
+    {
+        if (static_cast<int>(isa) > static_cast<int>(detectIsa()))
+            return false;
+        activeTable.store(tableFor(isa), std::memory_order_release);
+        return true;
+    }
+
+    const char *isaName(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::Avx512: return "AVX-512";
+        case Isa::Avx2: return "AVX2";
+        case Isa::Sse2: return "SSE2";
+        default: return "Scalar";
+        }
+    }
+
+    double sum(const double *data, std::size_t size)
+    {
+        return table().sum(data, size);
+    }
+
+    MinMax minMax(const double *data, std::size_t size)
+    {
+        return table().minMax(data, size);
+    }
+
+    PowerSums centralPowerSums(const double *data, std::size_t size, double center)
+    {
+        return table().centralPowerSums(data, size, center);
+    }
+
+    double reciprocalSum(const double *data, std::size_t size)
+    {
+        return table().reciprocalSum(data, size);
+    }
+
+    double logSum(const double *data, std::size_t size)
+    {
+        return table().logSum(data, size);
+    }
+
+    void normalCdf(const double *in, double *out, std::size_t size)
+    {
+        table().normalCdf(in, out, size);
+    }
+
+    void normalQuantile(const double *in, double *out, std::size_t size)
+    {
+        table().normalQuantile(in, out, size);
+    }
+}
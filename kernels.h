@@ -0,0 +1,66 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cmath>
+#include <cstddef>
+
+// Векторные редукции над непрерывными массивами double.
+// Реализация выбирается один раз при первом вызове по возможностям процессора
+// (SSE2 / AVX2 / AVX-512), суммы накапливаются с компенсацией Ноймайера.
+namespace Kernels
+{
+    enum class Isa { Scalar, Sse2, Avx2, Avx512 };
+
+    // Компенсированное суммирование (алгоритм Ноймайера)
+    struct NeumaierSum {
+        double sum = 0.0;
+        double compensation = 0.0;
+
+        void add(double value)
+        {
+            const double t = sum + value;
+            if (std::abs(sum) >= std::abs(value))
+                compensation += (sum - t) + value;
+            else
+                compensation += (value - t) + sum;
+            sum = t;
+        }
+        double value() const { return sum + compensation; }
+    };
+
+    struct MinMax {
+        double min;
+        double max;
+    };
+
+    // Суммы степеней отклонений от center: Σ(x-c), Σ(x-c)², Σ(x-c)³, Σ(x-c)⁴
+    struct PowerSums {
+        double s1;
+        double s2;
+        double s3;
+        double s4;
+    };
+
+    Isa activeIsa();
+    Isa detectIsa();
+    bool setIsa(Isa isa); // Для сравнения реализаций; false, если процессор не поддерживает
+    const char* isaName(Isa isa);
+
+    // Все ядра ожидают конечные значения; size может быть нулём
+    double sum(const double* data, std::size_t size);
+    MinMax minMax(const double* data, std::size_t size);
+    PowerSums centralPowerSums(const double* data, std::size_t size, double center);
+    double reciprocalSum(const double* data, std::size_t size);
+    // Только для положительных нормализованных значений (x >= DBL_MIN)
+    double logSum(const double* data, std::size_t size);
+
+    // Функция распределения стандартного нормального закона для массива (in и out
+    // могут совпадать). Абсолютная ошибка < 3e-16, относительная в нижнем хвосте
+    // < 1e-15 вплоть до x = -37.5; ниже результат — 0. nan сохраняется.
+    void normalCdf(const double* in, double* out, std::size_t size);
+    // Квантиль стандартного нормального закона. Относительная ошибка < 1e-15
+    // для p ∈ [DBL_MIN, 1); вне (0, 1) — nan.
+    void normalQuantile(const double* in, double* out, std::size_t size);
+}
+
+#endif // KERNELS_H
@@ -22,6 +22,7 @@ QWidget* MainWindow::setupTablePanel(QWidget* parent) {
     QWidget* tableSection = new QWidget(parent);
 
     this->m_table = Draw::setupTable(tableSection); // Создаем таблицу и возвращаем через outTable
+    this->m_seriesCache = new SeriesCache(m_table->tableModel(), this);
     auto* tableToolbar = setupTableToolbar(tableSection, m_table);
 
     QVBoxLayout* tableSectionLayout = new QVBoxLayout(tableSection);
@@ -71,14 +72,15 @@ QWidget* MainWindow::setupDataPanel(QWidget* parent)
                                                     &m_rmsLabel, &m_trimmedMeanLabel));
     statsLayout->addWidget(Draw::createDistributionSection(statsPanel, &m_medianLabel, &m_modeLabel, &m_stdDevLabel,
                                                            &m_skewnessLabel, &m_kurtosisLabel, &m_madLabel, &m_robustStdLabel,
-                                                           &m_shapiroWilkLabel, &m_densityLabel, &m_chiSquareLabel, &m_kolmogorovLabel));
+                                                           &m_shapiroWilkWLabel, &m_shapiroWilkLabel, &m_densityLabel,
+                                                           &m_chiSquareLabel, &m_kolmogorovLabel));
     statsLayout->addWidget(Draw::createExtremesSection(statsPanel, &m_minLabel, &m_maxLabel, &m_rangeLabel));
 
     statsLayout->addStretch();
     return statsPanel;
 }
 
-QWidget* MainWindow::setupTableToolbar(QWidget* parent, QTableWidget* table) {
+QWidget* MainWindow::setupTableToolbar(QWidget* parent, DataTable* table) {
     QWidget* toolbar = new QWidget(parent);
     toolbar->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
     QHBoxLayout* toolbarLayout = new QHBoxLayout(toolbar);
@@ -205,6 +207,14 @@ void MainWindow::setupTableActions()
     });
 }
 
+void MainWindow::setTableLocked(bool locked) {
+    const QList<QWidget*> widgets = {m_addRowBtn, m_delRowBtn, m_addColBtn, m_delColBtn,
+                                     m_clearBtn, m_rowSpin, m_colSpin, m_importBtn, m_exportBtn};
+    for (QWidget* widget : widgets) {
+        widget->setEnabled(!locked);
+    }
+}
+
 void MainWindow::setupGraphSettingsSlots() {
     connect(m_table->model(), &QAbstractItemModel::rowsInserted,
             this, &MainWindow::handleSeriesAdded);
@@ -212,16 +222,38 @@ void MainWindow::setupGraphSettingsSlots() {
     connect(m_table->model(), &QAbstractItemModel::rowsAboutToBeRemoved,
             this, &MainWindow::handleSeriesRemoved);
 
+    // Серии графика добавляются и удаляются только вместе с рядами таблицы
+    connect(m_table->model(), &QAbstractItemModel::rowsInserted,
+            this, &MainWindow::insertPlotSeries);
+    connect(m_table->model(), &QAbstractItemModel::rowsAboutToBeRemoved,
+            this, &MainWindow::removePlotSeries);
+
+    // Сброс модели (загрузка файла целиком) не присылает сигналов по рядам
+    connect(m_table->model(), &QAbstractItemModel::modelAboutToBeReset,
+            this, &MainWindow::handleModelAboutToBeReset);
+    connect(m_table->model(), &QAbstractItemModel::modelReset,
+            this, &MainWindow::handleModelReset);
+
     connect(m_xAxisTitleEdit, &QLineEdit::textChanged,
             this, &MainWindow::updateXAxisTitle);
 
     connect(m_yAxisTitleEdit, &QLineEdit::textChanged,
             this, &MainWindow::updateYAxisTitle);
+
+    // Видимая часть рядов зависит от окна оси X, ширины области и режима прореживания
+    if (m_chartView) {
+        connect(m_chartView->chart(), &QChart::plotAreaChanged, this, &MainWindow::scheduleViewUpdate);
+        connect(m_axisX, &QValueAxis::rangeChanged, this, &MainWindow::scheduleViewUpdate);
+        connect(m_chartView, &ChartView::viewReset, this, [this]() { updateAxisRanges(); });
+    }
+    connect(m_detailCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::scheduleViewUpdate);
 }
 
 void MainWindow::updateMarker(int seriesIndex, bool isMax) {
     // Проверяем валидность индекса
-    if (seriesIndex < 0 || seriesIndex >= m_table->rowCount()) return;
+    if (seriesIndex < 0 || seriesIndex >= m_table->rowCount() ||
+        seriesIndex >= m_minButtons.size() || seriesIndex >= m_maxButtons.size()) return;
 
     // Проверяем существование контейнера маркеров
     if (!m_seriesMarkers.contains(seriesIndex)) {
@@ -229,83 +261,69 @@ void MainWindow::updateMarker(int seriesIndex, bool isMax) {
     }
 
     auto& markers = m_seriesMarkers[seriesIndex];
-    QScatterSeries** marker = isMax ? &markers.maxMarker : &markers.minMarker;
-
-    // Удаляем только если маркер существует и добавлен на график
-    if (*marker && m_chartView->chart()->series().contains(*marker)) {
-        m_chartView->chart()->removeSeries(*marker);
-        delete* marker;
-       * marker = nullptr;
-    }
-
-    // Пересчитываем экстремум только если кнопка активна
-    if ((isMax && m_maxButtons[seriesIndex]->isChecked()) ||
-        (!isMax && m_minButtons[seriesIndex]->isChecked())) {
-
-        auto [val, col] = findExtremum(seriesIndex, isMax);
-        if (col != -1) {
-           * marker = Draw::createMarker(col, val, m_chartView->chart(), m_axisX, m_axisY, isMax);
-            // Дополнительная проверка перед добавлением
-            if (*marker && !m_chartView->chart()->series().contains(*marker)) {
-                m_chartView->chart()->addSeries(*marker);
-                (*marker)->attachAxis(m_axisX);
-                (*marker)->attachAxis(m_axisY);
-            }
+    QScatterSeries*& marker = isMax ? markers.maxMarker : markers.minMarker;
+    ExtremumTree& tree = isMax ? markers.maxTree : markers.minTree;
+
+    // Кнопка снята: маркер и дерево больше не нужны
+    if (!(isMax ? m_maxButtons : m_minButtons)[seriesIndex]->isChecked()) {
+        if (marker && m_chartView->chart()->series().contains(marker)) {
+            m_chartView->chart()->removeSeries(marker);
+            delete marker;
+            marker = nullptr;
         }
+        tree.clear();
+        return;
     }
-}
-
-void MainWindow::handleExtremumToggle(int seriesIndex, bool isMax, bool checked) {
-    if (seriesIndex < 0 || seriesIndex >= m_seriesMarkers.size()) return;
 
-    auto& markers = m_seriesMarkers[seriesIndex];
-    QScatterSeries** targetMarker = isMax ? &markers.maxMarker : &markers.minMarker;
-    QMetaObject::Connection* connection = isMax ? &markers.maxConnection : &markers.minConnection;
-
-    // Remove existing marker and disconnect its connection
-    if (*targetMarker) {
-        if (m_chartView && m_chartView->chart()) {
-            m_chartView->chart()->removeSeries(*targetMarker);
-        }
-        delete *targetMarker;
-        *targetMarker = nullptr;
+    const double* values = m_table->tableModel()->rowData(seriesIndex);
+    if (!tree.isBuilt()) {
+        tree.build(values, m_table->columnCount());
+    }
 
-        // Disconnect the specific connection
-        if (*connection) {
-            QObject::disconnect(*connection);
-            *connection = QMetaObject::Connection(); // Reset to null
-        }
+    const int col = tree.champion(values);
+    if (col == -1) {
+        if (marker) marker->clear();
+        return;
     }
 
-    if (checked) {
-        auto [value, col] = findExtremum(seriesIndex, isMax);
-        if (col != -1 && m_chartView && m_chartView->chart()) {
-            *targetMarker = Draw::createMarker(col, value, m_chartView->chart(),
-                                               m_axisX, m_axisY, isMax);
+    // Существующий маркер переезжает на новую точку, серия не пересоздаётся
+    const QPointF point(col, values[col]);
+    if (marker) {
+        marker->replace(QList<QPointF>{point});
+    } else {
+        marker = Draw::createMarker(point.x(), point.y(), m_chartView->chart(), m_axisX, m_axisY, isMax);
+    }
+}
 
-            // Connect dataChanged and store the connection
-            *connection = connect(m_table->model(), &QAbstractItemModel::dataChanged,
-                                  this, [=, this]() { updateExtremumMarker(seriesIndex, isMax); });
+void MainWindow::trackExtrema(const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+    // Деревья узнают об изменённых ячейках сразу, пересчёт экстремума — при показе маркера
+    const TableModel* model = m_table->tableModel();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        auto it = m_seriesMarkers.find(row);
+        if (it == m_seriesMarkers.end()) continue;
+
+        for (ExtremumTree* tree : {&it->minTree, &it->maxTree}) {
+            if (!tree->isBuilt()) continue;
+            for (int col = topLeft.column(); col <= bottomRight.column(); ++col) {
+                tree->update(model->rowData(row), col);
+            }
         }
     }
 }
 
-
-void MainWindow::updateExtremumMarker(int seriesIndex, bool isMax) {
-    if (seriesIndex < 0 ||
-        seriesIndex >= m_seriesMarkers.size() ||
-        seriesIndex >= m_maxButtons.size() ||
-        seriesIndex >= m_minButtons.size()) return;
-
-    auto& markers = m_seriesMarkers[seriesIndex];
-    QScatterSeries** targetMarker = isMax ? &markers.maxMarker : &markers.minMarker;
-    QPushButton* btn = isMax ? m_maxButtons[seriesIndex] : m_minButtons[seriesIndex];
-
-    if (btn->isChecked()) {
-        handleExtremumToggle(seriesIndex, isMax, true);
+void MainWindow::resetExtremumTrees() {
+    // Столбцы сдвинулись: деревья строятся заново при следующем показе маркера
+    for (SeriesMarkers& markers : m_seriesMarkers) {
+        markers.minTree.clear();
+        markers.maxTree.clear();
     }
 }
 
+void MainWindow::handleExtremumToggle(int seriesIndex, bool isMax, bool /*checked*/) {
+    // Кнопка уже переключена: updateMarker снимет маркер или поставит его заново
+    updateMarker(seriesIndex, isMax);
+}
+
 void MainWindow::handleSeriesAdded(const QModelIndex &parent, int first, int last) {
     if (QVBoxLayout* layout = qobject_cast<QVBoxLayout*>(m_seriesSettingsContent->layout())) {
         for(int row = first; row <= last; ++row) {
@@ -379,17 +397,13 @@ std::pair<double, int> MainWindow::findExtremum(int seriesIndex, bool findMax) {
     if(seriesIndex < 0 || seriesIndex >= m_table->rowCount())
         return {extremumVal, extremumCol};
 
-    for(int col = 0; col < m_table->columnCount(); ++col) {
-        if(auto item = m_table->item(seriesIndex, col)) {
-            bool ok;
-            double val = item->text().toDouble(&ok);
-            if(ok) {
-                if((findMax && val > extremumVal) || (!findMax && val < extremumVal)) {
-                    extremumVal = val;
-                    extremumCol = col;
-                }
-            }
-        }
+    // Экстремум ряда с индексом первого вхождения хранится в вершине пирамиды
+    const SeriesData& series = m_seriesCache->series(seriesIndex);
+    if(!series.empty()) {
+        const RangeStats total = m_seriesCache->pyramid(seriesIndex).total();
+        const std::size_t index = findMax ? total.argMax : total.argMin;
+        extremumVal = series.values[index];
+        extremumCol = series.x[index];
     }
     return {extremumVal, extremumCol};
 }
@@ -420,12 +434,7 @@ bool MainWindow::isSeriesEmpty(int seriesIndex) const {
     if(seriesIndex < 0 || seriesIndex >= m_table->rowCount())
         return true;
 
-    for(int col = 0; col < m_table->columnCount(); ++col) {
-        if(auto item = m_table->item(seriesIndex, col)) {
-            if(!item->text().isEmpty()) return false;
-        }
-    }
-    return true;
+    return m_table->tableModel()->valueCount(seriesIndex) == 0;
 }
 
 void MainWindow::refreshLegend() {
@@ -457,10 +466,13 @@ void MainWindow::handleShowMax(int seriesIndex) {
 }
 
 void MainWindow::updateSeriesNames() {
-    for(int i = 0; i < m_seriesNameEdits.size(); ++i) {
-        if(QAbstractSeries* series = m_chartView->chart()->series().value(i)) {
-            series->setName(m_seriesNameEdits[i]->text());
+    for(int i = 0; i < m_lineSeries.size(); ++i) {
+        // Имя из поля ввода или по умолчанию
+        QString seriesName = "Наименование ";
+        if (i < m_seriesNameEdits.size() && !m_seriesNameEdits[i]->text().isEmpty()) {
+            seriesName = m_seriesNameEdits[i]->text();
         }
+        m_lineSeries[i]->setName(seriesName);
     }
 }
 
@@ -471,44 +483,13 @@ bool MainWindow::areAllLabelsDefined() {
     return m_table != nullptr;
 }
 
-TableData MainWindow::parse() const {
-    TableData plotData;
-    for (int row = 0; row < m_table->rowCount(); ++row) {
-        std::vector<std::pair<int, int>> rowData;
-
-        for (int col = 0; col < m_table->columnCount(); ++col) {
-            if (auto item = m_table->item(row, col)) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
-                if (ok) {
-                    rowData.emplace_back(col, value);
-                }
-            }
-        }
-
-        if (!rowData.empty()) {
-            plotData.push_back(rowData);
-        }
-    }
-    return plotData;
-}
-
-std::vector<std::pair<int, int>> MainWindow::getSelectedRowData() const {
-    std::vector<std::pair<int, int>> selectedData;
+const SeriesData& MainWindow::getSelectedRowData() const {
+    static const SeriesData empty;
     const int targetRow = m_rowToCalculateCombo->currentIndex();
-
     if(targetRow >= 0 && targetRow < m_table->rowCount()) {
-        for(int col = 0; col < m_table->columnCount(); ++col) {
-            if(auto item = m_table->item(targetRow, col)) {
-                bool ok;
-                double value = item->text().toDouble(&ok);
-                if(ok) {
-                    selectedData.emplace_back(col, value);
-                }
-            }
-        }
+        return m_seriesCache->series(targetRow);
     }
-    return selectedData;
+    return empty;
 }
 
 void MainWindow::setupChartAxes() {
@@ -518,82 +499,121 @@ void MainWindow::setupChartAxes() {
 
     m_chartView->chart()->addAxis(m_axisX, Qt::AlignBottom);
     m_chartView->chart()->addAxis(m_axisY, Qt::AlignLeft);
+    m_chartView->setZoomAxis(m_axisX);
+
+    // Плотность выбранного ряда откладывается вдоль оси значений, её шкала — сверху
+    m_densityAxis = Draw::setupAxis("Плотность", 0, 1);
+    m_densityAxis->setLabelFormat("%.2f");
+    m_chartView->chart()->addAxis(m_densityAxis, Qt::AlignTop);
+
+    m_densitySeries = new QLineSeries();
+    m_densitySeries->setName("Плотность");
+    QPen pen(QColor("#6B5B95"));
+    pen.setWidth(2);
+    pen.setStyle(Qt::DashLine);
+    m_densitySeries->setPen(pen);
+    m_chartView->chart()->addSeries(m_densitySeries);
+    m_densitySeries->attachAxis(m_densityAxis);
+    m_densitySeries->attachAxis(m_axisY);
 }
 
 void MainWindow::initializeChart() {
     QWidget* graphSection = findChild<QWidget*>("graphSection");
 
     if (graphSection) {
-        m_chartView = graphSection->findChild<QChartView*>();
+        m_chartView = graphSection->findChild<ChartView*>();
 
         if (m_chartView) {
             setupChartAxes();
+            insertPlotSeries(QModelIndex(), 0, m_table->rowCount() - 1);
             m_chartView->setRenderHint(QPainter::Antialiasing);
             m_chartView->chart()->setBackgroundBrush(Qt::white);
         }
     }
 }
 
-void MainWindow::updateAxesRange(const TableData& data) {
-    double minX = std::numeric_limits<double>::max();
-    double maxX = std::numeric_limits<double>::min();
-    double minY = std::numeric_limits<double>::max();
-    double maxY = std::numeric_limits<double>::min();
-
-    // Ищем минимальные и максимальные значения
-    for (const auto& series : data) {
-        for (const auto& [x, y] : series) {
-            minX = std::min(minX, static_cast<double>(x));
-            maxX = std::max(maxX, static_cast<double>(x));
-            minY = std::min(minY, static_cast<double>(y));
-            maxY = std::max(maxY, static_cast<double>(y));
-        }
+void MainWindow::insertPlotSeries(const QModelIndex& /*parent*/, int first, int last) {
+    if (!m_chartView || !m_axisX || !m_axisY) return;
+
+    for (int row = first; row <= last; ++row) {
+        QLineSeries* series = createSeries(row, false);
+        series->setVisible(false); // Пустой ряд не рисуется и не попадает в легенду
+        m_chartView->chart()->addSeries(series);
+        attachSeriesToAxes(series);
+
+        m_lineSeries.insert(row, series);
+        m_seriesBounds.insert(row, SeriesBounds());
     }
+    updateSeriesNames();
+}
 
-    // Устанавливаем новые границы с небольшим запасом
-    const double padding = 0.1;
-    m_axisX->setRange(minX - padding, maxX + padding);
-    m_axisY->setRange(minY - padding, maxY + padding);
+void MainWindow::removePlotSeries(const QModelIndex& /*parent*/, int first, int last) {
+    for (int row = qMin(last, m_lineSeries.size() - 1); row >= first; --row) {
+        m_chartView->chart()->removeSeries(m_lineSeries[row]);
+        delete m_lineSeries[row];
+        m_lineSeries.remove(row);
+        m_seriesBounds.remove(row);
+    }
 }
 
-void MainWindow::plotData(const TableData& data) {
-    if (!m_chartView || !m_axisX || !m_axisY) return;
+void MainWindow::handleModelAboutToBeReset() {
+    const int rows = m_lineSeries.size();
+    if (rows > 0) {
+        handleSeriesRemoved(QModelIndex(), 0, rows - 1);
+        removePlotSeries(QModelIndex(), 0, rows - 1);
+    }
+}
 
-    clearChart();
+void MainWindow::handleModelReset() {
+    // Серии и поля рядов пересоздаются под новую таблицу, а пересчёт
+    // статистики и графика — один, через scheduleFullUpdate
+    const int rows = m_table->rowCount();
+    if (rows > 0) {
+        insertPlotSeries(QModelIndex(), 0, rows - 1);
+        handleSeriesAdded(QModelIndex(), 0, rows - 1);
+    }
+    updateRowSelectionCombo();
+}
 
-    double minX = std::numeric_limits<double>::max();
-    double maxX = std::numeric_limits<double>::lowest();
-    double minY = std::numeric_limits<double>::max();
-    double maxY = std::numeric_limits<double>::lowest();
+void MainWindow::plotRow(int row) {
+    if (row < 0 || row >= m_lineSeries.size()) return;
 
-    for (size_t i = 0; i < data.size(); ++i) {
-        // Создаем серию один раз
-        QLineSeries* series = createSeries(i,false);
+    m_seriesBounds[row] = seriesBounds(row);
+    m_lineSeries[row]->setVisible(!m_seriesCache->series(row).empty());
+}
 
-        // Устанавливаем имя из поля ввода или по умолчанию
-        QString seriesName = "Наименование ";
-        if (i < static_cast<size_t>(m_seriesNameEdits.size())) {
-            seriesName = m_seriesNameEdits[i]->text().isEmpty()
-                       ? seriesName
-                       : m_seriesNameEdits[i]->text();
-        }
-        series->setName(seriesName);
+void MainWindow::sliceRow(int row) {
+    if (row < 0 || row >= m_lineSeries.size()) return;
 
-        // Добавляем точки и обновляем границы
-        addPointsToSeries(series, data[i], minX, maxX, minY, maxY);
+    // На график уходит только окно оси X, прореженное под ширину области построения
+    int pixelWidth = qRound(m_chartView->chart()->plotArea().width());
+    if (pixelWidth <= 0) pixelWidth = m_chartView->width(); // Область ещё не размечена
 
-        // Добавляем серию на график
-        m_chartView->chart()->addSeries(series);
-        attachSeriesToAxes(series);
+    const auto mode = static_cast<Downsample::Mode>(m_detailCombo->currentData().toInt());
+    m_lineSeries[row]->replace(Downsample::visiblePoints(
+        m_seriesCache->series(row), m_seriesCache->pyramid(row),
+        m_axisX->min(), m_axisX->max(), pixelWidth, mode));
+}
+
+void MainWindow::plotDensity(const SeriesData& data) {
+    if (!m_densitySeries || !m_densityAxis) return;
+
+    const Calculate::DensityCurve curve = Calculate::densityCurve(data.values);
+    if (curve.density.empty()) {
+        m_densitySeries->clear();
+        m_densityAxis->setRange(0, 1);
+        return;
     }
 
-    updateAxisRanges(minX, maxX, minY, maxY);
-    m_chartView->chart()->update();
-}
-void MainWindow::clearChart() {
-    if (m_chartView) {
-        m_chartView->chart()->removeAllSeries();
+    QList<QPointF> points;
+    points.reserve(curve.grid.size());
+    for (size_t i = 0; i < curve.grid.size(); ++i) {
+        points.append(QPointF(curve.density[i], curve.grid[i]));
     }
+    m_densitySeries->replace(points); // Одна вставка вместо поточечного append
+
+    const double peak = *std::max_element(curve.density.begin(), curve.density.end());
+    m_densityAxis->setRange(0, peak * 1.1);
 }
 
 void MainWindow::addPointsToSeriesGraph(int seriesIndex, QLineSeries* series) {
@@ -623,19 +643,18 @@ QLineSeries* MainWindow::createSeries(int seriesIndex, bool showPoints) {
     return series;
 }
 
-void MainWindow::addPointsToSeries(QLineSeries* series,
-                                   const std::vector<std::pair<int, int>>& data,
-                                   double& minX, double& maxX,
-                                   double& minY, double& maxY) {
-    for (const auto& [x, y] : data) {
-        QPointF point(x, y);
-        series->append(point.x(), point.y());
-
-        minX = qMin(minX, point.x());
-        maxX = qMax(maxX, point.x());
-        minY = qMin(minY, point.y());
-        maxY = qMax(maxY, point.y());
-    }
+SeriesBounds MainWindow::seriesBounds(int row) {
+    SeriesBounds bounds;
+    const SeriesData& data = m_seriesCache->series(row);
+    if (data.empty()) return bounds;
+
+    // Столбцы ряда идут по возрастанию, экстремумы значений лежат в вершине пирамиды
+    const RangeStats total = m_seriesCache->pyramid(row).total();
+    bounds.minX = data.x.front();
+    bounds.maxX = data.x.back();
+    bounds.minY = total.min;
+    bounds.maxY = total.max;
+    return bounds;
 }
 
 void MainWindow::attachSeriesToAxes(QXYSeries* series) {
@@ -643,89 +662,125 @@ void MainWindow::attachSeriesToAxes(QXYSeries* series) {
     series->attachAxis(m_axisY);
 }
 
+void MainWindow::fitVisibleY() {
+    // Окно X задано пользователем: шкала Y подбирается по видимым точкам
+    // запросом к пирамиде каждого ряда, O(log n) на ряд
+    double minY = std::numeric_limits<double>::max();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (int row = 0; row < m_lineSeries.size(); ++row) {
+        const SeriesData& data = m_seriesCache->series(row);
+        const auto first = std::lower_bound(data.x.begin(), data.x.end(), m_axisX->min()) - data.x.begin();
+        const auto last = std::upper_bound(data.x.begin(), data.x.end(), m_axisX->max()) - data.x.begin();
+        const RangeStats visible = m_seriesCache->pyramid(row).query(data, first, last);
+        if (visible.count == 0) continue;
+        minY = qMin(minY, visible.min);
+        maxY = qMax(maxY, visible.max);
+    }
+    if (minY <= maxY) {
+        const double yPadding = qMax((maxY - minY) * 0.1, 0.5);
+        m_axisY->setRange(minY - yPadding, maxY + yPadding);
+    }
+}
+
+void MainWindow::updateAxisRanges() {
+    // Оси собираются из сохранённых границ рядов, данные повторно не обходятся
+    SeriesBounds total;
+    for (const SeriesBounds& bounds : m_seriesBounds) {
+        total.minX = qMin(total.minX, bounds.minX);
+        total.maxX = qMax(total.maxX, bounds.maxX);
+        total.minY = qMin(total.minY, bounds.minY);
+        total.maxY = qMax(total.maxY, bounds.maxY);
+    }
+    updateAxisRanges(total.minX, total.maxX, total.minY, total.maxY);
+}
+
 void MainWindow::updateAxisRanges(double minX, double maxX, double minY, double maxY) {
-    if (minX == std::numeric_limits<double>::max()) { // Нет данных
+    const bool empty = minX == std::numeric_limits<double>::max(); // Нет данных
+    const double xPadding = (maxX - minX)*  0.1;
+    const double yPadding = (maxY - minY)*  0.1;
+
+    // Полный диапазон обновляется и при масштабе: данные могли вырасти
+    if (empty)
+        m_chartView->setFullRange(0, 10);
+    else
+        m_chartView->setFullRange(minX - xPadding, maxX + xPadding);
+
+    if (m_chartView->isZoomed()) {
+        fitVisibleY();
+        return;
+    }
+    if (empty) {
         m_axisX->setRange(0, 10);
         m_axisY->setRange(0, 10);
         return;
     }
 
-    const double xPadding = (maxX - minX)*  0.1;
-    const double yPadding = (maxY - minY)*  0.1;
-
     m_axisX->setRange(minX - xPadding, maxX + xPadding);
     m_axisY->setRange(minY - yPadding, maxY + yPadding);
 }
 
-QString formatValue(double value, int precision = 2) {
-    return QString::number(value, 'f', precision);
-}
+void MainWindow::updateUI(const SeriesData& data) {
+    cancelMetricsJob();
+    const quint64 generation = ++m_metricsGeneration;
 
-template<typename Func, typename... Args>
-QString MainWindow::calculateAndFormat(bool hasData, Func func, Args&&... args) const {
-    return hasData ? formatValue(func(std::forward<Args>(args)...)) : na;
-}
+    if (data.empty()) {
+        applyMetricTexts(QStringList());
+        return;
+    }
 
-void MainWindow::updateBasicMetrics(bool hasData, const std::vector<double>& values, double mean) {
-    m_elementCountLabel->setText(hasData ? QString::number(values.size()) : na);
-    m_sumLabel->setText(calculateAndFormat(hasData, Calculate::getSum, values));
-    m_averageLabel->setText(calculateAndFormat(hasData, [mean](){ return mean; }));
-}
+    // Ряд не менялся с открытия рабочей области: метрики уже посчитаны
+    const auto cached = m_cachedMetrics.constFind(m_rowToCalculateCombo->currentIndex());
+    if (cached != m_cachedMetrics.constEnd()) {
+        const auto& registry = Metrics::registry();
+        QStringList texts;
+        for (int i = 0; i < registry.size(); ++i)
+            texts << Metrics::format(cached->value(i, qQNaN()), registry[i].precision);
+        applyMetricTexts(texts);
+        return;
+    }
 
-void MainWindow::updateAverages(bool hasData, const std::vector<double>& values) {
-    m_geometricMeanLabel->setText(calculateAndFormat(hasData, Calculate::geometricMean, values));
-    m_harmonicMeanLabel->setText(calculateAndFormat(hasData, Calculate::harmonicMean, values));
-    m_rmsLabel->setText(calculateAndFormat(hasData, Calculate::rootMeanSquare, values));
-    m_trimmedMeanLabel->setText(calculateAndFormat(hasData,
-                                                   Calculate::trimmedMean, values, trimmedMeanPercentage));
-}
+    // Расчёт идёт в пуле потоков над собственной копией значений; между метриками
+    // задача проверяет отмену, а в GUI-поток возвращаются только готовые тексты
+    m_metricsJob = QtConcurrent::run([values = data.values](QPromise<QStringList>& promise) {
+        // Общие входы (моменты, отсортированный снимок) строятся один раз на все метрики
+        const Metrics::RowContext row(values, Metrics::requiredInputs());
 
-void MainWindow::updateDistribution(bool hasData, const std::vector<double>& values, double mean, double stdDev) {
-    m_medianLabel->setText(calculateAndFormat(hasData, Calculate::getMedian, values));
-    m_modeLabel->setText(calculateAndFormat(hasData, Calculate::getMode, values));
-    m_stdDevLabel->setText(calculateAndFormat(hasData, [stdDev](){ return stdDev; }));
-    m_skewnessLabel->setText(calculateAndFormat(hasData, Calculate::skewness, values, mean, stdDev));
-    m_kurtosisLabel->setText(calculateAndFormat(hasData, Calculate::kurtosis, values, mean, stdDev));
-    m_madLabel->setText(calculateAndFormat(hasData, Calculate::medianAbsoluteDeviation, values));
-    m_robustStdLabel->setText(calculateAndFormat(hasData, Calculate::robustStandardDeviation, values));
-}
+        QStringList texts;
+        for (const Metrics::Metric& metric : Metrics::registry()) {
+            if (promise.isCanceled()) return;
+            texts << Metrics::format(Metrics::compute(metric, row), metric.precision);
+        }
+        promise.addResult(texts);
+    });
 
-void MainWindow::updateStatisticalTests(bool hasData, const std::vector<double>& values, double mean) {
-    m_shapiroWilkLabel->setText(calculateAndFormat(hasData, Calculate::shapiroWilkTest, values));
-    m_densityLabel->setText(calculateAndFormat(hasData, Calculate::calculateDensity, values, mean));
-    m_chiSquareLabel->setText(calculateAndFormat(hasData, Calculate::chiSquareTest, values));
-    m_kolmogorovLabel->setText(calculateAndFormat(hasData, Calculate::kolmogorovSmirnovTest, values));
+    auto* watcher = new QFutureWatcher<QStringList>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, generation]() {
+        watcher->deleteLater();
+        // Результат устаревшего или отменённого расчёта отбрасывается
+        if (generation != m_metricsGeneration || watcher->isCanceled() || watcher->future().resultCount() == 0)
+            return;
+        applyMetricTexts(watcher->result());
+    });
+    watcher->setFuture(m_metricsJob);
 }
 
-void MainWindow::updateExtremes(bool hasData, double min, double max, double range) {
-    auto format = [](double val){ return QString::number(val, 'f', statsPrecision); };
-    m_minLabel->setText(hasData ? format(min) : na);
-    m_maxLabel->setText(hasData ? format(max) : na);
-    m_rangeLabel->setText(hasData ? format(range) : na);
+void MainWindow::cancelMetricsJob() {
+    if (m_metricsJob.isRunning()) {
+        m_metricsJob.cancel();
+    }
 }
 
-void MainWindow::updateUI(const TableData& data) {
-    const bool hasData = !data.empty() && !data[0].empty();
-    std::vector<double> values;
+void MainWindow::applyMetricTexts(const QStringList& texts) {
+    QHash<QString, QLabel*> labels;
+    for (const auto& [name, label] : getMetricsList())
+        labels.insert(name, label);
 
-    if(hasData) {
-        values.reserve(data[0].size());
-        for(const auto& pair : data[0]) {
-            values.push_back(pair.second);
-        }
+    // Пустой список — нет данных
+    const auto& registry = Metrics::registry();
+    for (int i = 0; i < registry.size(); ++i) {
+        if (QLabel* label = labels.value(registry[i].name))
+            label->setText(i < texts.size() ? texts[i] : na);
     }
-
-    const double mean = hasData ? Calculate::getMean(values) : 0.0;
-    const double stdDev = hasData ? Calculate::getStandardDeviation(values, mean) : 0.0;
-    const double min = hasData ?* std::min_element(values.begin(), values.end()) : 0.0;
-    const double max = hasData ?* std::max_element(values.begin(), values.end()) : 0.0;
-    const double range = max - min;
-
-    updateBasicMetrics(hasData, values, mean);
-    updateAverages(hasData, values);
-    updateDistribution(hasData, values, mean, stdDev);
-    updateStatisticalTests(hasData, values, mean);
-    updateExtremes(hasData, min, max, range);
 }
 
 QList<QPair<QString, QLabel*>> MainWindow::getMetricsList() const {
@@ -744,6 +799,7 @@ QList<QPair<QString, QLabel*>> MainWindow::getMetricsList() const {
         {"Эксцесс", m_kurtosisLabel},
         {"Медианное абс. отклонение", m_madLabel},
         {"Робастное стан. отклонение", m_robustStdLabel},
+        {"Статистика W Шапиро-Уилка", m_shapiroWilkWLabel},
         {"Тест Шапиро-Уилка", m_shapiroWilkLabel},
         {"Плотность распределения", m_densityLabel},
         {"χ²-критерий", m_chiSquareLabel},
@@ -754,35 +810,79 @@ QList<QPair<QString, QLabel*>> MainWindow::getMetricsList() const {
     };
 }
 
+void MainWindow::scheduleUpdate(int firstRow, int lastRow) {
+    for (int row = firstRow; row <= lastRow; ++row) {
+        m_dirtyRows.insert(row);
+    }
+
+    // Идущий расчёт по изменённому ряду уже не нужен
+    const int selectedRow = m_rowToCalculateCombo->currentIndex();
+    if (selectedRow >= firstRow && selectedRow <= lastRow) {
+        cancelMetricsJob();
+    }
+    m_updateTimer->start();
+}
+
+void MainWindow::scheduleFullUpdate() {
+    // Структура таблицы изменилась — номера рядов в кэше метрик больше не верны
+    m_cachedMetrics.clear();
+    m_allRowsDirty = true;
+    m_updateTimer->start();
+}
+
+void MainWindow::scheduleViewUpdate() {
+    m_viewDirty = true;
+    m_updateTimer->start();
+}
+
 void MainWindow::updateStatistics() {
     if (!areAllLabelsDefined()) return;
 
-    const TableData allData = parse(); // Все данные для графиков
-    const auto selectedData = getSelectedRowData(); // Данные для метрик
+    const bool allDirty = std::exchange(m_allRowsDirty, false);
+    const QSet<int> dirtyRows = std::exchange(m_dirtyRows, QSet<int>());
+    m_updateTimer->stop();
 
-    // Создаем временную TableData для совместимости с updateUI
-    TableData metricsData;
-    if(!selectedData.empty()) {
-        metricsData.push_back(selectedData);
+    // Метрики и плотность пересчитываются, только если изменился выбранный ряд
+    const int selectedRow = m_rowToCalculateCombo->currentIndex();
+    if (allDirty || dirtyRows.contains(selectedRow)) {
+        const SeriesData& selectedData = getSelectedRowData();
+        updateUI(selectedData);
+        plotDensity(selectedData); // Кривая плотности выбранного ряда поверх графиков
     }
 
-    updateUI(metricsData); // Передаем только выбранный ряд для метрик
-    plotData(allData); // Передаем все данные для отрисовки графиков
+    // Серии графика живут вместе с рядами таблицы: обновляются только изменённые
+    QList<int> rows = dirtyRows.values();
+    if (allDirty) {
+        rows.resize(m_lineSeries.size());
+        std::iota(rows.begin(), rows.end(), 0);
+    }
+    for (int row : rows) {
+        if (row < 0 || row >= m_table->rowCount()) continue;
+
+        plotRow(row);
+        updateButtonsState(row);
+        if (row < m_minButtons.size() && m_minButtons[row]->isChecked()) updateMarker(row, false);
+        if (row < m_maxButtons.size() && m_maxButtons[row]->isChecked()) updateMarker(row, true);
+    }
 
-    for(int i = 0; i < m_table->rowCount(); ++i) {
-        updateButtonsState(i);
+    // Смена диапазона осей взводит m_viewDirty: тогда перенарезаются все ряды
+    updateAxisRanges();
+    if (std::exchange(m_viewDirty, false) || allDirty) {
+        rows.resize(m_lineSeries.size());
+        std::iota(rows.begin(), rows.end(), 0);
     }
+    for (int row : rows) {
+        sliceRow(row);
+    }
+    m_updateTimer->stop();
     refreshLegend();
 }
 
 void MainWindow::updateXAxisTitle() {
     if(m_chartView && m_chartView->chart()) {
-        // Получаем все горизонтальные оси
-        QList<QAbstractAxis*> xAxes = m_chartView->chart()->axes(Qt::Horizontal);
-        if(!xAxes.isEmpty()) {
-            if(QValueAxis* xAxis = qobject_cast<QValueAxis*>(xAxes.first())) {
-                xAxis->setTitleText(m_xAxisTitleEdit->text());
-            }
+        // Горизонтальных осей две (значения и плотность), заголовок меняется только у оси X
+        if(m_axisX) {
+            m_axisX->setTitleText(m_xAxisTitleEdit->text());
         }
     }
 }
@@ -809,27 +909,35 @@ void MainWindow::setupPalette() {
 }
 
 void MainWindow::setupTableSlots() {
-    connect(m_table, &QTableWidget::currentCellChanged, [this](int row, int, int, int) {
-        updateStatistics();
-    });
-
-    connect(m_table, &QTableWidget::itemChanged, this, &MainWindow::updateStatistics);
-
-    connect(m_table->model(), &QAbstractItemModel::dataChanged, [this]() {
-        const int rows = m_table->rowCount();
-        const int buttonsCount = qMin(m_minButtons.size(), m_maxButtons.size());
-
-        for (int i = 0; i < qMin(rows, buttonsCount); ++i) {
-            if (m_minButtons[i]->isChecked() || m_maxButtons[i]->isChecked()) {
-                QTimer::singleShot(0, [this, i]() { // Добавляем задержку
-                    if (i < m_table->rowCount()) { // Проверка актуальности индекса
-                        if (m_minButtons[i]->isChecked()) updateMarker(i, false);
-                        if (m_maxButtons[i]->isChecked()) updateMarker(i, true);
-                    }
-                });
-            }
-        }
-    });
+    // Все правки за одну итерацию цикла событий сводятся в один вызов updateStatistics
+    m_updateTimer = new QTimer(this);
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(0);
+    connect(m_updateTimer, &QTimer::timeout, this, &MainWindow::updateStatistics);
+
+    connect(m_table->model(), &QAbstractItemModel::dataChanged, this,
+            [this](const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+                trackExtrema(topLeft, bottomRight);
+                for (int row = topLeft.row(); row <= bottomRight.row() && !m_cachedMetrics.isEmpty(); ++row)
+                    m_cachedMetrics.remove(row);
+                scheduleUpdate(topLeft.row(), bottomRight.row());
+            });
+
+    // Ряды с данными приходят пачками при импорте
+    connect(m_table->model(), &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex&, int first, int last) {
+                if (last + 1 < m_table->rowCount())
+                    m_cachedMetrics.clear(); // Вставка в середину сдвигает номера рядов
+                scheduleUpdate(first, last);
+            });
+
+    // Удаление рядов и столбцов сдвигает индексы, поэтому пересчитывается всё
+    connect(m_table->model(), &QAbstractItemModel::rowsRemoved, this, &MainWindow::scheduleFullUpdate);
+    connect(m_table->model(), &QAbstractItemModel::columnsRemoved, this, &MainWindow::scheduleFullUpdate);
+    connect(m_table->model(), &QAbstractItemModel::modelReset, this, &MainWindow::scheduleFullUpdate);
+    connect(m_table->model(), &QAbstractItemModel::columnsInserted, this, &MainWindow::resetExtremumTrees);
+    connect(m_table->model(), &QAbstractItemModel::columnsRemoved, this, &MainWindow::resetExtremumTrees);
+    connect(m_table->model(), &QAbstractItemModel::modelReset, this, &MainWindow::resetExtremumTrees);
 
     // Обновление списка рядов
     connect(m_table->model(), &QAbstractItemModel::rowsInserted,
@@ -839,7 +947,7 @@ void MainWindow::setupTableSlots() {
 
     // Обработка выбора ряда
     connect(m_rowToCalculateCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
-            this, &MainWindow::updateStatistics);
+            this, [this](int index) { scheduleUpdate(index, index); });
 }
 
 void MainWindow::updateRowSelectionCombo() {
@@ -875,6 +983,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     // Объявляем переменные для хранения элементов управления
     QLineEdit* xAxisEdit = nullptr;
     QLineEdit* yAxisEdit = nullptr;
+    QComboBox* detailCombo = nullptr;
     QWidget* seriesContent = nullptr;
 
     QWidget* dataSection = setupDataSection(mainWidget);
@@ -882,12 +991,14 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
         mainWidget,
         &xAxisEdit,
         &yAxisEdit,
+        &detailCombo,
         &seriesContent
         );
 
     // Сохраняем ссылки на элементы управления
     m_xAxisTitleEdit = xAxisEdit;
     m_yAxisTitleEdit = yAxisEdit;
+    m_detailCombo = detailCombo;
     m_seriesSettingsContent = seriesContent;
 
     QVBoxLayout* mainLayout = new QVBoxLayout(mainWidget);
@@ -919,4 +1030,6 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     this->setWindowTitle(QString::fromStdString("Glacé"));
 }
 
-MainWindow::~MainWindow() {}
+MainWindow::~MainWindow() {
+    cancelMetricsJob();
+}
@@ -7,9 +7,12 @@
 #include "structs.h"
 #include "export.h"
 #include "import.h"
+#include "metrics.h"
+#include "tableModel.h"
+#include "downsample.h"
+#include "extremumTree.h"
 
 #include <QMainWindow>
-#include <QTableWidget>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QLabel>
@@ -38,6 +41,12 @@
 #include <QScatterSeries>
 #include <QValueAxis>
 #include <QLineSeries>
+#include <QSet>
+#include <QTimer>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QtConcurrent>
 
 #include <limits>
 #include <iostream>
@@ -45,8 +54,16 @@
 struct SeriesMarkers {
     QScatterSeries* maxMarker = nullptr;
     QScatterSeries* minMarker = nullptr;
-    QMetaObject::Connection maxConnection;
-    QMetaObject::Connection minConnection;
+    ExtremumTree maxTree{true};  // Строятся при первом показе маркера
+    ExtremumTree minTree{false};
+};
+
+// Границы точек ряда на графике: оси собираются из них без обхода данных
+struct SeriesBounds {
+    double minX = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double minY = std::numeric_limits<double>::max();
+    double maxY = std::numeric_limits<double>::lowest();
 };
 
 class MainWindow : public QMainWindow
@@ -57,7 +74,10 @@ public:
     ~MainWindow();
 private slots:
     void updateStatistics();
-    void plotData(const TableData& data);
+    void insertPlotSeries(const QModelIndex &parent, int first, int last);
+    void removePlotSeries(const QModelIndex &parent, int first, int last);
+    void handleModelAboutToBeReset();
+    void handleModelReset();
     void updateXAxisTitle();
     void updateYAxisTitle();
     void updateSeriesNames();
@@ -70,7 +90,15 @@ private:
     QWidget* m_seriesSettingsContent;
     QLineEdit* m_xAxisTitleEdit;
     QLineEdit* m_yAxisTitleEdit;
-    QTableWidget* m_table = nullptr;
+    QComboBox* m_detailCombo = nullptr;
+    DataTable* m_table = nullptr;
+    SeriesCache* m_seriesCache = nullptr; // Ряды таблицы, перестраиваются только изменённые
+    QTimer* m_updateTimer = nullptr;      // Сводит все правки за итерацию цикла событий в один пересчёт
+    QSet<int> m_dirtyRows;
+    bool m_allRowsDirty = true;
+    QFuture<QStringList> m_metricsJob;    // Фоновый расчёт метрик выбранного ряда
+    quint64 m_metricsGeneration = 0;      // Номер последнего запущенного расчёта
+    QHash<int, QVector<double>> m_cachedMetrics; // Метрики из рабочей области до первой правки ряда
     QPushButton* m_addColBtn = nullptr;
     QPushButton* m_delColBtn = nullptr;
     QPushButton* m_clearBtn = nullptr;
@@ -100,14 +128,20 @@ private:
     QLabel* m_madLabel = nullptr;
     QLabel* m_rmsLabel = nullptr;
     QLabel* m_robustStdLabel = nullptr;
+    QLabel* m_shapiroWilkWLabel = nullptr;
     QLabel* m_shapiroWilkLabel = nullptr;
     QLabel* m_densityLabel = nullptr;
     QLabel* m_chiSquareLabel = nullptr;
     QLabel* m_kolmogorovLabel = nullptr;
     QLabel* m_rowToCalculateLabel = nullptr;
-    QChartView* m_chartView = nullptr;
+    ChartView* m_chartView = nullptr;
     QValueAxis* m_axisX = nullptr;
     QValueAxis* m_axisY = nullptr;
+    QValueAxis* m_densityAxis = nullptr;
+    QLineSeries* m_densitySeries = nullptr;
+    QVector<QLineSeries*> m_lineSeries;   // Серия графика на каждый ряд таблицы, живёт вместе с рядом
+    QVector<SeriesBounds> m_seriesBounds;
+    bool m_viewDirty = false;             // Сменилось окно осей или ширина графика: ряды нарезаются заново
 
     QVector<QLineEdit*> m_seriesNameEdits;
     QVector<QColor> m_seriesColors {
@@ -120,16 +154,20 @@ private:
     QVector<QPushButton*> m_minButtons;
     QVector<QPushButton*> m_maxButtons;
 
-    void clearChart();
-    void updateExtremumMarker(int seriesIndex, bool isMax);
+    void plotDensity(const SeriesData& data);
+    void scheduleUpdate(int firstRow, int lastRow);
+    void trackExtrema(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+    void resetExtremumTrees();
+    void scheduleFullUpdate();
+    void scheduleViewUpdate();
+    void plotRow(int row);
+    void sliceRow(int row);
     void handleExtremumToggle(int seriesIndex, bool isMax, bool checked);
     QLineSeries* createSeries(int seriesIndex, bool showPoints = false);
-    void addPointsToSeries(QLineSeries* series,
-                           const std::vector<std::pair<int, int>>& data,
-                           double& minX, double& maxX,
-                           double& minY, double& maxY);
+    SeriesBounds seriesBounds(int row);
+    void updateAxisRanges();
+    void fitVisibleY();
     void updateAxisRanges(double minX, double maxX, double minY, double maxY);
-    TableData parse() const;
     QWidget* setupDataSection(QWidget* parent);
     QWidget* setupDataPanel(QWidget* parent);
     QWidget* createBasicDataSection(QWidget* parent, QLabel* *elementCountLabel, QLabel* *sumLabel, QLabel* *averageLabel);
@@ -137,11 +175,12 @@ private:
     QWidget* createDistributionSection(QWidget* parent);
     QWidget* createExtremesSection(QWidget* parent);
     QWidget* createCorrelationSection(QWidget* parent);
-    void updateAxesRange(const TableData& data);
-    QWidget* setupTableToolbar(QWidget* parent, QTableWidget* table);
+    QWidget* setupTableToolbar(QWidget* parent, DataTable* table);
     QWidget* setupTablePanel(QWidget* parent);
     void setupTableActions();
-    void updateUI(const TableData& data);
+    void updateUI(const SeriesData& data);
+    void cancelMetricsJob();
+    void applyMetricTexts(const QStringList& texts);
     void createDataHeader(QWidget* statsPanel, QVBoxLayout* statsLayout);
     bool areAllLabelsDefined();
     void setupChartAxes();
@@ -160,16 +199,9 @@ private:
     QColor getBorderColor(int index) const;
     void addPointsToSeriesGraph(int seriesIndex, QLineSeries* series);
     void loadStylesheets();
-    void updateBasicMetrics(bool hasData, const std::vector<double>& values, double mean);
-    void updateAverages(bool hasData, const std::vector<double>& values);
-    void updateDistribution(bool hasData, const std::vector<double>& values, double mean, double stdDev);
-    void updateStatisticalTests(bool hasData, const std::vector<double>& values, double mean);
-    void updateExtremes(bool hasData, double min, double max, double range);
     QList<QPair<QString, QLabel*>> getMetricsList() const;
-    template<typename Func, typename... Args>
-    QString calculateAndFormat(bool hasData, Func func, Args&&... args) const;
     void updateRowSelectionCombo();
-    std::vector<std::pair<int, int>> getSelectedRowData() const;
+    const SeriesData& getSelectedRowData() const;
 
 public:
     QStringList getSeriesHeaders() const {
@@ -187,6 +219,15 @@ public:
             m_seriesNameEdits[i]->setText(headers[i]);
         }
     }
+
+    // Кнопки и спинбоксы, меняющие таблицу, на время фонового импорта
+    void setTableLocked(bool locked);
+
+    // Значения в порядке реестра метрик; сбрасываются при правке ряда
+    void setCachedMetrics(const QHash<int, QVector<double>>& metrics) {
+        scheduleFullUpdate(); // Сбрасывает прежний кэш, поэтому новый ставится после
+        m_cachedMetrics = metrics;
+    }
 };
 
 #endif // MAINWINDOW_H
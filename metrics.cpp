@@ -0,0 +1,123 @@
+#include "metrics.h"
+
+namespace Metrics
+{
+    RowContext::RowContext(std::vector<double> data, unsigned inputs)
+        : values(std::move(data))
+    {
+        if (inputs & Moments)
+            moments = Calculate::MomentAccumulator(values);
+        if (inputs & Sorted)
+            sorted = Calculate::SortedSample(values);
+        if (inputs & Frequency)
+            frequencies = Calculate::FrequencyTable(values);
+    }
+
+    const QVector<Metric>& registry()
+    {
+        static const QVector<Metric> metrics = {
+            {"Количество элементов", NoInput, [](const RowContext& row) {
+                 return static_cast<double>(row.values.size());
+             }, 0},
+            {"Сумма", Moments, [](const RowContext& row) {
+                 return Calculate::getSum(row.moments);
+             }},
+            {"Среднее арифметическое", Moments, [](const RowContext& row) {
+                 return Calculate::getMean(row.moments);
+             }},
+            {"Геометрическое среднее", Moments, [](const RowContext& row) {
+                 return Calculate::geometricMean(row.moments);
+             }},
+            {"Гармоническое среднее", Moments, [](const RowContext& row) {
+                 return Calculate::harmonicMean(row.moments);
+             }},
+            {"Квадратичное среднее", Moments, [](const RowContext& row) {
+                 return Calculate::rootMeanSquare(row.moments);
+             }},
+            {"Усечённое среднее", Sorted, [](const RowContext& row) {
+                 return Calculate::trimmedMean(row.sorted, trimmedMeanPercentage);
+             }},
+            {"Медиана", Sorted, [](const RowContext& row) {
+                 return Calculate::getMedian(row.sorted);
+             }},
+            {"Мода", Frequency, [](const RowContext& row) {
+                 return Calculate::getMode(row.frequencies);
+             }},
+            {"Стандартное отклонение", Moments, [](const RowContext& row) {
+                 return Calculate::getStandardDeviation(row.moments);
+             }},
+            {"Асимметрия", Moments, [](const RowContext& row) {
+                 return Calculate::skewness(row.moments);
+             }},
+            {"Эксцесс", Moments, [](const RowContext& row) {
+                 return Calculate::kurtosis(row.moments);
+             }},
+            {"Медианное абс. отклонение", Sorted, [](const RowContext& row) {
+                 return Calculate::medianAbsoluteDeviation(row.sorted);
+             }},
+            {"Робастное стан. отклонение", Sorted, [](const RowContext& row) {
+                 return Calculate::robustStandardDeviation(row.sorted);
+             }},
+            {"Статистика W Шапиро-Уилка", Sorted | Moments, [](const RowContext& row) {
+                 return Calculate::shapiroWilk(row.sorted, row.moments).w;
+             }, statsPrecision},
+            {"Тест Шапиро-Уилка", Sorted | Moments, [](const RowContext& row) {
+                 return Calculate::shapiroWilkTest(row.sorted, row.moments);
+             }},
+            {"Плотность распределения", Sorted | Moments, [](const RowContext& row) {
+                 const std::vector<double> q = Calculate::quantiles(row.sorted, {0.25, 0.75});
+                 const double bandwidth = Calculate::kdeBandwidth(row.moments, q[1] - q[0]);
+                 return Calculate::calculateDensity(row.values, Calculate::getMean(row.moments), bandwidth);
+             }},
+            {"χ²-критерий", Moments, [](const RowContext& row) {
+                 return Calculate::chiSquareTest(row.values, row.moments);
+             }},
+            {"Критерий Колмогорова-Смирнова", Sorted | Moments, [](const RowContext& row) {
+                 return Calculate::kolmogorovSmirnovTest(row.sorted, row.moments);
+             }},
+            {"Минимум", Moments, [](const RowContext& row) {
+                 return row.moments.min;
+             }, statsPrecision},
+            {"Максимум", Moments, [](const RowContext& row) {
+                 return row.moments.max;
+             }, statsPrecision},
+            {"Размах", Moments, [](const RowContext& row) {
+                 return row.moments.max - row.moments.min;
+             }, statsPrecision}
+        };
+        return metrics;
+    }
+
+    unsigned requiredInputs()
+    {
+        unsigned inputs = NoInput;
+        for (const Metric& metric : registry())
+            inputs |= metric.inputs;
+        return inputs;
+    }
+
+    double compute(const Metric& metric, const RowContext& row)
+    {
+        try {
+            return metric.compute(row);
+        } catch (...) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+
+    QVector<double> evaluate(const std::vector<double>& values)
+    {
+        const RowContext row(values, requiredInputs());
+
+        QVector<double> results;
+        results.reserve(registry().size());
+        for (const Metric& metric : registry())
+            results.append(compute(metric, row));
+        return results;
+    }
+
+    QString format(double value, int precision)
+    {
+        return QString::number(value, 'f', precision);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QString>
+#include <QVector>
+
+#include "calculate.h"
+#include "globals.h"
+
+#include <functional>
+#include <vector>
+
+// Реестр метрик ряда. Каждая метрика объявляет, какие общие промежуточные
+// результаты ей нужны, и вычислитель строит каждый из них не более одного раза.
+namespace Metrics
+{
+    enum Input : unsigned {
+        NoInput = 0,
+        Moments = 1u << 0,   // Среднее, дисперсия, старшие моменты, min/max
+        Sorted = 1u << 1,    // Отсортированный снимок для порядковых статистик
+        Frequency = 1u << 2, // Таблица частот значений
+    };
+
+    // Промежуточные результаты ряда. Строятся в конструкторе только для
+    // запрошенных входов, дальше только читаются — в том числе из разных потоков.
+    struct RowContext
+    {
+        std::vector<double> values;
+        Calculate::MomentAccumulator moments;
+        Calculate::SortedSample sorted;
+        Calculate::FrequencyTable frequencies;
+
+        RowContext(std::vector<double> data, unsigned inputs);
+    };
+
+    struct Metric
+    {
+        QString name;
+        unsigned inputs;
+        std::function<double(const RowContext&)> compute;
+        int precision = 2;
+    };
+
+    const QVector<Metric>& registry();
+    unsigned requiredInputs(); // Объединение входов всех метрик реестра
+
+    double compute(const Metric& metric, const RowContext& row); // nan при исключении
+    QVector<double> evaluate(const std::vector<double>& values);
+    QString format(double value, int precision);
+}
+
+#endif // METRICS_H
@@ -1,7 +1,6 @@
 #ifndef NUMERICDELEGATE_H
 #define NUMERICDELEGATE_H
 
-#include <QTableWidget>
 #include <QStyledItemDelegate>
 #include <QLineEdit>
 #include <QDoubleValidator>
@@ -0,0 +1,102 @@
+#include "pyramid.h"
+#include "kernels.h"
+
+#include <algorithm>
+
+void RangeStats::merge(const RangeStats& other)
+{
+    if (other.count == 0) return;
+    if (other.min < min) {
+        min = other.min;
+        argMin = other.argMin;
+    }
+    if (other.max > max) {
+        max = other.max;
+        argMax = other.argMax;
+    }
+    sum += other.sum;
+    count += other.count;
+}
+
+namespace
+{
+    // Прямой проход по отрезку векторными ядрами
+    RangeStats scan(const double* values, std::size_t first, std::size_t last)
+    {
+        RangeStats stats;
+        if (first >= last) return stats;
+
+        const std::size_t size = last - first;
+        const Kernels::MinMax range = Kernels::minMax(values + first, size);
+        stats.min = range.min;
+        stats.max = range.max;
+        stats.argMin = std::find(values + first, values + last, range.min) - values;
+        stats.argMax = std::find(values + first, values + last, range.max) - values;
+        stats.sum = Kernels::sum(values + first, size);
+        stats.count = size;
+        return stats;
+    }
+}
+
+Pyramid::Pyramid(const SeriesData& data)
+{
+    const std::size_t size = data.size();
+    if (size == 0) return;
+
+    std::vector<RangeStats> blocks((size + PYRAMID_BLOCK - 1) / PYRAMID_BLOCK);
+    for (std::size_t block = 0; block < blocks.size(); ++block) {
+        const std::size_t first = block * PYRAMID_BLOCK;
+        blocks[block] = scan(data.values.data(), first, std::min(size, first + PYRAMID_BLOCK));
+    }
+    m_levels.push_back(std::move(blocks));
+
+    while (m_levels.back().size() > 1) {
+        const std::vector<RangeStats>& below = m_levels.back();
+        std::vector<RangeStats> level((below.size() + 1) / 2);
+        for (std::size_t i = 0; i < level.size(); ++i) {
+            level[i] = below[2 * i];
+            if (2 * i + 1 < below.size())
+                level[i].merge(below[2 * i + 1]);
+        }
+        m_levels.push_back(std::move(level));
+    }
+}
+
+RangeStats Pyramid::query(const SeriesData& data, std::size_t first, std::size_t last) const
+{
+    const double* values = data.values.data();
+    last = std::min(last, data.size());
+    if (first >= last) return RangeStats();
+
+    // Полные блоки внутри отрезка берутся из пирамиды, края — прямым проходом
+    std::size_t left = (first + PYRAMID_BLOCK - 1) / PYRAMID_BLOCK;
+    std::size_t right = last / PYRAMID_BLOCK;
+    if (left >= right)
+        return scan(values, first, last);
+
+    RangeStats head = scan(values, first, left * PYRAMID_BLOCK);
+    RangeStats tail = scan(values, right * PYRAMID_BLOCK, last);
+
+    // Снизу вверх: непарный крайний узел уровня сливается сразу, остальные
+    // поднимаются к родителю. Правые узлы копятся отдельно, чтобы сохранить порядок
+    for (const std::vector<RangeStats>& level : m_levels) {
+        if (left >= right) break;
+        if (left & 1)
+            head.merge(level[left++]);
+        if (right & 1) {
+            RangeStats node = level[--right];
+            node.merge(tail);
+            tail = node;
+        }
+        left /= 2;
+        right /= 2;
+    }
+
+    head.merge(tail);
+    return head;
+}
+
+RangeStats Pyramid::total() const
+{
+    return m_levels.empty() ? RangeStats() : m_levels.back().front();
+}
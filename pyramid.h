@@ -0,0 +1,41 @@
+#ifndef PYRAMID_H
+#define PYRAMID_H
+
+#include "globals.h"
+#include "structs.h"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Сводка по отрезку ряда: экстремумы с индексами первых вхождений, сумма и длина
+struct RangeStats {
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+    double sum = 0.0;
+    std::size_t argMin = 0;
+    std::size_t argMax = 0;
+    std::size_t count = 0;
+
+    // other лежит правее: при равенстве остаётся более ранний индекс
+    void merge(const RangeStats& other);
+};
+
+// Пирамида сводок ряда (дерево отрезков): уровень 0 — блоки по PYRAMID_BLOCK
+// точек, каждый следующий уровень сливает соседние пары. Запрос по любому
+// отрезку индексов — O(log n) узлов и не больше двух неполных блоков
+class Pyramid
+{
+public:
+    Pyramid() = default;
+    explicit Pyramid(const SeriesData& data);
+
+    // Отрезок [first, last) ряда data, по которому построена пирамида
+    RangeStats query(const SeriesData& data, std::size_t first, std::size_t last) const;
+    RangeStats total() const;
+
+private:
+    std::vector<std::vector<RangeStats>> m_levels;
+};
+
+#endif // PYRAMID_H
@@ -1,9 +1,21 @@
 #ifndef STRUCTS_H
 #define STRUCTS_H
 
+#include <cstddef>
 #include <vector>
-#include <utility>
 
-using TableData = std::vector<std::vector<std::pair<int, int>>>;
+// Ряд для метрик и графика: номера столбцов и значения лежат в двух
+// непрерывных массивах одной длины, без пары на каждую точку
+struct SeriesData {
+    std::vector<int> x;         // Столбец таблицы
+    std::vector<double> values; // Значение в этом столбце
+
+    void reserve(std::size_t size) { x.reserve(size); values.reserve(size); }
+    void append(int column, double value) { x.push_back(column); values.push_back(value); }
+    std::size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+};
+
+using TableData = std::vector<SeriesData>;
 
 #endif // STRUCTS_H
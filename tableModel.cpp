@@ -0,0 +1,381 @@
+#include "tableModel.h"
+
+TableModel::Series::Series(int columns)
+{
+    resize(columns);
+}
+
+TableModel::Series::Series(std::vector<double>&& data, int columns)
+    : values(std::move(data)), mask(maskWords(columns), 0)
+{
+    values.resize(columns, std::numeric_limits<double>::quiet_NaN());
+    for (int col = 0; col < columns; ++col) {
+        if (!std::isnan(values[col])) {
+            mask[col >> 6] |= std::uint64_t(1) << (col & 63);
+            ++count;
+        }
+    }
+}
+
+void TableModel::Series::resize(int columns)
+{
+    values.resize(columns, std::numeric_limits<double>::quiet_NaN());
+    mask.resize(maskWords(columns), 0);
+
+    // Биты за последним столбцом при сужении сбрасываются
+    if (columns & 63)
+        mask.back() &= (std::uint64_t(1) << (columns & 63)) - 1;
+
+    count = 0;
+    for (std::uint64_t word : mask)
+        count += qPopulationCount(word);
+}
+
+TableModel::TableModel(int rows, int columns, QObject* parent)
+    : QAbstractTableModel(parent), m_series(rows, Series(columns)), m_columns(columns)
+{
+}
+
+int TableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_series.size());
+}
+
+int TableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_columns;
+}
+
+QVariant TableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole))
+        return QVariant();
+    if (!hasValue(index.row(), index.column()))
+        return QString();
+    return formatValue(value(index.row(), index.column()));
+}
+
+bool TableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole)
+        return false;
+
+    const QString text = value.toString().trimmed();
+    if (text.isEmpty() || text == "-") {
+        clearValue(index.row(), index.column());
+        return true;
+    }
+
+    bool ok;
+    const double number = QLocale::c().toDouble(text, &ok);
+    if (!ok)
+        return false;
+    setValue(index.row(), index.column(), number);
+    return true;
+}
+
+Qt::ItemFlags TableModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
+
+bool TableModel::insertRows(int row, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || row < 0 || row > rowCount() || count <= 0)
+        return false;
+
+    beginInsertRows(parent, row, row + count - 1);
+    m_series.insert(m_series.begin() + row, count, Series(m_columns));
+    endInsertRows();
+    return true;
+}
+
+bool TableModel::removeRows(int row, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > rowCount())
+        return false;
+
+    beginRemoveRows(parent, row, row + count - 1);
+    m_series.erase(m_series.begin() + row, m_series.begin() + row + count);
+    endRemoveRows();
+    return true;
+}
+
+bool TableModel::insertColumns(int column, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || column < 0 || column > m_columns || count <= 0)
+        return false;
+
+    beginInsertColumns(parent, column, column + count - 1);
+    const int columns = m_columns + count;
+    for (Series& series : m_series) {
+        if (column == m_columns) {
+            series.resize(columns); // Дописывание в конец — частый случай
+            continue;
+        }
+        Series shifted(columns);
+        for (int col = 0; col < m_columns; ++col) {
+            if (series.test(col)) {
+                const int target = col < column ? col : col + count;
+                shifted.values[target] = series.values[col];
+                shifted.mask[target >> 6] |= std::uint64_t(1) << (target & 63);
+            }
+        }
+        shifted.count = series.count;
+        series = std::move(shifted);
+    }
+    m_columns = columns;
+    endInsertColumns();
+    return true;
+}
+
+bool TableModel::removeColumns(int column, int count, const QModelIndex& parent)
+{
+    if (parent.isValid() || column < 0 || count <= 0 || column + count > m_columns)
+        return false;
+
+    beginRemoveColumns(parent, column, column + count - 1);
+    const int columns = m_columns - count;
+    for (Series& series : m_series) {
+        if (column + count == m_columns) {
+            series.resize(columns);
+            continue;
+        }
+        Series shifted(columns);
+        for (int col = 0; col < m_columns; ++col) {
+            if (series.test(col) && (col < column || col >= column + count)) {
+                const int target = col < column ? col : col - count;
+                shifted.values[target] = series.values[col];
+                shifted.mask[target >> 6] |= std::uint64_t(1) << (target & 63);
+                shifted.count++;
+            }
+        }
+        series = std::move(shifted);
+    }
+    m_columns = columns;
+    endRemoveColumns();
+    return true;
+}
+
+void TableModel::setRowCount(int rows)
+{
+    if (rows > rowCount())
+        insertRows(rowCount(), rows - rowCount());
+    else if (rows < rowCount())
+        removeRows(rows, rowCount() - rows);
+}
+
+void TableModel::setColumnCount(int columns)
+{
+    if (columns > m_columns)
+        insertColumns(m_columns, columns - m_columns);
+    else if (columns < m_columns)
+        removeColumns(columns, m_columns - columns);
+}
+
+void TableModel::clearContents()
+{
+    for (Series& series : m_series) {
+        std::fill(series.values.begin(), series.values.end(), std::numeric_limits<double>::quiet_NaN());
+        std::fill(series.mask.begin(), series.mask.end(), 0);
+        series.count = 0;
+    }
+    if (!m_series.empty() && m_columns > 0)
+        emit dataChanged(index(0, 0), index(rowCount() - 1, m_columns - 1));
+}
+
+void TableModel::appendRows(std::vector<std::vector<double>> rows)
+{
+    if (rows.empty())
+        return;
+
+    int columns = m_columns;
+    for (const std::vector<double>& values : rows)
+        columns = std::max(columns, static_cast<int>(values.size()));
+    setColumnCount(columns);
+
+    const int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(rows.size()) - 1);
+    m_series.reserve(m_series.size() + rows.size());
+    for (std::vector<double>& values : rows)
+        m_series.emplace_back(std::move(values), m_columns);
+    endInsertRows();
+}
+
+void TableModel::loadRows(std::vector<std::vector<double>> rows, int columns)
+{
+    replaceRows(std::move(rows), columns);
+}
+
+std::vector<std::vector<double>> TableModel::replaceRows(std::vector<std::vector<double>> rows, int columns)
+{
+    for (const std::vector<double>& values : rows)
+        columns = std::max(columns, static_cast<int>(values.size()));
+
+    // На месте пропусков в рядах и так лежит nan, поэтому массивы отдаются без копирования
+    std::vector<std::vector<double>> previous;
+    previous.reserve(m_series.size());
+
+    beginResetModel();
+    for (Series& series : m_series)
+        previous.push_back(std::move(series.values));
+    m_columns = columns;
+    m_series.clear();
+    m_series.reserve(rows.size());
+    for (std::vector<double>& values : rows)
+        m_series.emplace_back(std::move(values), m_columns);
+    endResetModel();
+    return previous;
+}
+
+bool TableModel::hasValue(int row, int column) const
+{
+    return row >= 0 && row < rowCount() && column >= 0 && column < m_columns
+           && m_series[row].test(column);
+}
+
+double TableModel::value(int row, int column) const
+{
+    return hasValue(row, column) ? m_series[row].values[column]
+                                 : std::numeric_limits<double>::quiet_NaN();
+}
+
+void TableModel::setValue(int row, int column, double value)
+{
+    Series& series = m_series[row];
+    if (!series.test(column)) {
+        series.mask[column >> 6] |= std::uint64_t(1) << (column & 63);
+        series.count++;
+    }
+    series.values[column] = value;
+
+    const QModelIndex cell = index(row, column);
+    emit dataChanged(cell, cell);
+}
+
+void TableModel::clearValue(int row, int column)
+{
+    Series& series = m_series[row];
+    if (!series.test(column))
+        return;
+    series.mask[column >> 6] &= ~(std::uint64_t(1) << (column & 63));
+    series.values[column] = std::numeric_limits<double>::quiet_NaN();
+    series.count--;
+
+    const QModelIndex cell = index(row, column);
+    emit dataChanged(cell, cell);
+}
+
+int TableModel::lastValueColumn(int row) const
+{
+    const std::vector<std::uint64_t>& mask = m_series[row].mask;
+    for (int word = static_cast<int>(mask.size()) - 1; word >= 0; --word) {
+        if (mask[word])
+            return word * 64 + 63 - qCountLeadingZeroBits(mask[word]);
+    }
+    return -1;
+}
+
+std::vector<double> TableModel::rowValues(int row) const
+{
+    const Series& series = m_series[row];
+    std::vector<double> values;
+    values.reserve(series.count);
+
+    // Обход по словам маски: пустые блоки по 64 ячейки пропускаются целиком
+    for (std::size_t word = 0; word < series.mask.size(); ++word) {
+        for (std::uint64_t bits = series.mask[word]; bits; bits &= bits - 1)
+            values.push_back(series.values[word * 64 + qCountTrailingZeroBits(bits)]);
+    }
+    return values;
+}
+
+SeriesData TableModel::series(int row) const
+{
+    const Series& series = m_series[row];
+    SeriesData data;
+    data.reserve(series.count);
+
+    for (std::size_t word = 0; word < series.mask.size(); ++word) {
+        for (std::uint64_t bits = series.mask[word]; bits; bits &= bits - 1) {
+            const int column = static_cast<int>(word * 64 + qCountTrailingZeroBits(bits));
+            data.append(column, series.values[column]);
+        }
+    }
+    return data;
+}
+
+QString TableModel::formatValue(double value)
+{
+    return QLocale::c().toString(value, 'g', QLocale::FloatingPointShortest);
+}
+
+SeriesCache::SeriesCache(const TableModel* model, QObject* parent)
+    : QObject(parent), m_model(model),
+      m_series(model->rowCount()), m_pyramids(model->rowCount()),
+      m_dirty(model->rowCount(), 1), m_pyramidDirty(model->rowCount(), 1)
+{
+    connect(model, &QAbstractItemModel::dataChanged, this,
+            [this](const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+                invalidate(topLeft.row(), bottomRight.row());
+            });
+    connect(model, &QAbstractItemModel::rowsInserted, this,
+            [this](const QModelIndex&, int first, int last) {
+                m_series.insert(m_series.begin() + first, last - first + 1, SeriesData());
+                m_pyramids.insert(m_pyramids.begin() + first, last - first + 1, Pyramid());
+                m_dirty.insert(m_dirty.begin() + first, last - first + 1, 1);
+                m_pyramidDirty.insert(m_pyramidDirty.begin() + first, last - first + 1, 1);
+            });
+    connect(model, &QAbstractItemModel::rowsRemoved, this,
+            [this](const QModelIndex&, int first, int last) {
+                m_series.erase(m_series.begin() + first, m_series.begin() + last + 1);
+                m_pyramids.erase(m_pyramids.begin() + first, m_pyramids.begin() + last + 1);
+                m_dirty.erase(m_dirty.begin() + first, m_dirty.begin() + last + 1);
+                m_pyramidDirty.erase(m_pyramidDirty.begin() + first, m_pyramidDirty.begin() + last + 1);
+            });
+    connect(model, &QAbstractItemModel::columnsInserted, this,
+            [this](const QModelIndex&, int first, int last) {
+                // Пустые столбцы в конце не меняют ни одного ряда
+                if (last + 1 < m_model->columnCount())
+                    invalidateAll();
+            });
+    connect(model, &QAbstractItemModel::columnsRemoved, this, &SeriesCache::invalidateAll);
+    connect(model, &QAbstractItemModel::modelReset, this, [this]() {
+        m_series.assign(m_model->rowCount(), SeriesData());
+        m_pyramids.assign(m_model->rowCount(), Pyramid());
+        m_dirty.assign(m_model->rowCount(), 1);
+        m_pyramidDirty.assign(m_model->rowCount(), 1);
+    });
+}
+
+const SeriesData& SeriesCache::series(int row)
+{
+    if (m_dirty[row]) {
+        m_series[row] = m_model->series(row);
+        m_dirty[row] = 0;
+        m_pyramidDirty[row] = 1;
+    }
+    return m_series[row];
+}
+
+const Pyramid& SeriesCache::pyramid(int row)
+{
+    const SeriesData& data = series(row);
+    if (m_pyramidDirty[row]) {
+        m_pyramids[row] = Pyramid(data);
+        m_pyramidDirty[row] = 0;
+    }
+    return m_pyramids[row];
+}
+
+void SeriesCache::invalidate(int first, int last)
+{
+    std::fill(m_dirty.begin() + first, m_dirty.begin() + last + 1, 1);
+}
+
+void SeriesCache::invalidateAll()
+{
+    std::fill(m_dirty.begin(), m_dirty.end(), 1);
+}
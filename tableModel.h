@@ -0,0 +1,129 @@
+#ifndef TABLEMODEL_H
+#define TABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QTableView>
+#include <QHeaderView>
+#include <QLocale>
+#include <QVariant>
+#include <QtAlgorithms>
+
+#include "structs.h"
+#include "pyramid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Модель таблицы: каждый ряд хранится непрерывным массивом double на все
+// столбцы и битовой маской заполненных ячеек. Пропуски ("-") — это сброшенные
+// биты, в массиве на их месте лежит nan. Строки создаются только для показа.
+class TableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    TableModel(int rows, int columns, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    bool insertRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+    bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
+    bool insertColumns(int column, int count, const QModelIndex& parent = QModelIndex()) override;
+    bool removeColumns(int column, int count, const QModelIndex& parent = QModelIndex()) override;
+
+    void setRowCount(int rows);
+    void setColumnCount(int columns);
+    void clearContents(); // Размеры сохраняются, все ячейки становятся пропусками
+
+    // Готовые ряды (nan — пропуск) дописываются в конец одним rowsInserted без
+    // сигнала на ячейку; таблица расширяется до самого широкого из них
+    void appendRows(std::vector<std::vector<double>> rows);
+    // Вся таблица заменяется готовыми рядами одним modelReset
+    void loadRows(std::vector<std::vector<double>> rows, int columns = 0);
+    // То же, но прежние ряды (nan — пропуск) отдаются, чтобы их можно было вернуть
+    std::vector<std::vector<double>> replaceRows(std::vector<std::vector<double>> rows, int columns = 0);
+
+    bool hasValue(int row, int column) const;
+    double value(int row, int column) const; // nan для пропуска
+    void setValue(int row, int column, double value);
+    void clearValue(int row, int column);
+
+    // Прямой доступ к ряду: columnCount() значений и маска по 64 ячейки на слово
+    const double* rowData(int row) const { return m_series[row].values.data(); }
+    const std::uint64_t* rowMask(int row) const { return m_series[row].mask.data(); }
+    int valueCount(int row) const { return m_series[row].count; }
+    int lastValueColumn(int row) const; // -1 для пустого ряда
+    std::vector<double> rowValues(int row) const; // Только заполненные ячейки по порядку
+    SeriesData series(int row) const;             // То же вместе с номерами столбцов
+
+    static QString formatValue(double value);
+
+private:
+    struct Series
+    {
+        std::vector<double> values;
+        std::vector<std::uint64_t> mask;
+        int count = 0; // Заполненных ячеек
+
+        explicit Series(int columns);
+        Series(std::vector<double>&& data, int columns);
+        void resize(int columns);
+        bool test(int column) const { return mask[column >> 6] >> (column & 63) & 1; }
+    };
+
+    std::vector<Series> m_series;
+    int m_columns = 0;
+
+    static int maskWords(int columns) { return (columns + 63) / 64; }
+};
+
+// Ряды модели в виде SeriesData. Ряд перестраивается при первом обращении после
+// того, как модель сообщила об изменении его ячеек; остальные берутся готовыми
+class SeriesCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SeriesCache(const TableModel* model, QObject* parent = nullptr);
+
+    const SeriesData& series(int row);
+    const Pyramid& pyramid(int row); // Строится по первому запросу после изменения ряда
+    void invalidate(int first, int last);
+    void invalidateAll();
+
+private:
+    const TableModel* m_model;
+    std::vector<SeriesData> m_series;
+    std::vector<Pyramid> m_pyramids;
+    std::vector<char> m_dirty;
+    std::vector<char> m_pyramidDirty;
+};
+
+// Представление таблицы над TableModel с привычным интерфейсом размеров
+class DataTable : public QTableView
+{
+public:
+    DataTable(int rows, int columns, QWidget* parent = nullptr)
+        : QTableView(parent), m_model(new TableModel(rows, columns, this))
+    {
+        setModel(m_model);
+    }
+
+    TableModel* tableModel() const { return m_model; }
+
+    int rowCount() const { return m_model->rowCount(); }
+    int columnCount() const { return m_model->columnCount(); }
+    void setRowCount(int rows) { m_model->setRowCount(rows); }
+    void setColumnCount(int columns) { m_model->setColumnCount(columns); }
+    void clearContents() { m_model->clearContents(); }
+
+private:
+    TableModel* m_model;
+};
+
+#endif // TABLEMODEL_H
@@ -0,0 +1,180 @@
+// Рабочая область .svb: сохранение и открытие без потерь и совпадение
+// с тем, что даёт текстовый экспорт и импорт той же таблицы
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "../export.h"
+#include "../import.h"
+#include "../workspace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    const double gap = std::numeric_limits<double>::quiet_NaN();
+
+    // Ряды разной длины с пропусками в середине; таблица шире самого длинного
+    std::vector<std::vector<double>> sampleRows()
+    {
+        return {
+            {1.0, gap, 3.0, 0.1 + 0.2},
+            {-2.5e-7, 4.0},
+            {gap, gap, 7.0, 8.0, 1e300, -0.0, 2.5e-300},
+            {42.0},
+            {gap, 1.0 / 3.0, gap, gap, gap, gap, gap, gap, gap, 2.0},
+        };
+    }
+
+    // Заполненные ячейки совпадают по столбцам и побитово по значениям
+    void compareRows(const TableModel* actual, const TableModel* expected)
+    {
+        QCOMPARE(actual->rowCount(), expected->rowCount());
+        for (int row = 0; row < expected->rowCount(); ++row) {
+            const SeriesData a = actual->series(row);
+            const SeriesData e = expected->series(row);
+            QVERIFY(a.x == e.x);
+            QVERIFY(std::memcmp(a.values.data(), e.values.data(), e.values.size() * sizeof(double)) == 0);
+        }
+    }
+}
+
+class WorkspaceTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init()
+    {
+        QVERIFY(m_dir.isValid());
+        m_source = new DataTable(initialRowCount, initialColCount);
+        m_source->tableModel()->loadRows(sampleRows(), 12);
+        m_headers = QStringList{"Ряд A", "Температура °C", "x", "Ряд 4", "Последний"};
+    }
+
+    void cleanup()
+    {
+        delete m_source;
+    }
+
+    void roundTrip()
+    {
+        const QString path = m_dir.filePath("table.svb");
+        Workspace::Extras saved;
+        saved.seriesHeaders = m_headers;
+        QVERIFY(Workspace::computeMetrics(m_source->tableModel(), nullptr, saved.metrics));
+        QCOMPARE(int(saved.metrics.size()), m_source->rowCount());
+        QVERIFY(Workspace::save(path, m_source->tableModel(), saved));
+
+        DataTable loaded(initialRowCount, initialColCount);
+        Workspace::Extras extras;
+        QString error;
+        QVERIFY2(Workspace::load(path, loaded.tableModel(), extras, error), qPrintable(error));
+
+        QCOMPARE(loaded.columnCount(), m_source->columnCount());
+        compareRows(loaded.tableModel(), m_source->tableModel());
+        QCOMPARE(extras.seriesHeaders, m_headers);
+
+        QList<int> keys = extras.metrics.keys();
+        QList<int> savedKeys = saved.metrics.keys();
+        std::sort(keys.begin(), keys.end());
+        std::sort(savedKeys.begin(), savedKeys.end());
+        QCOMPARE(keys, savedKeys);
+        for (auto it = saved.metrics.cbegin(); it != saved.metrics.cend(); ++it) {
+            const QVector<double>& metrics = extras.metrics[it.key()];
+            QCOMPARE(metrics.size(), it->size());
+            QVERIFY(std::memcmp(metrics.constData(), it->constData(), it->size() * sizeof(double)) == 0);
+        }
+    }
+
+    void matchesTextFormat()
+    {
+        const TableModel* model = m_source->tableModel();
+        const QString svbPath = m_dir.filePath("table.svb");
+        const QString txtPath = m_dir.filePath("table.txt");
+
+        Workspace::Extras saved;
+        saved.seriesHeaders = m_headers;
+        QVERIFY(Workspace::save(svbPath, model, saved));
+
+        const TableMetrics tableMetrics = Export::calculateTableMetrics(model);
+        QVERIFY(Export::processExportDialog(txtPath, {}, Export::prepareTableRows(model, tableMetrics.maxNonEmptyCols),
+                                            m_headers));
+
+        DataTable fromSvb(initialRowCount, initialColCount);
+        Workspace::Extras extras;
+        QString error;
+        QVERIFY2(Workspace::load(svbPath, fromSvb.tableModel(), extras, error), qPrintable(error));
+
+        DataTable fromTxt(initialRowCount, initialColCount);
+        Import::importTextFile(&fromTxt, txtPath);
+        QTRY_VERIFY_WITH_TIMEOUT(!fromTxt.property("importRunning").toBool(), 10000);
+
+        // Текст хранит только ширину до последнего значения, двоичный файл — всю таблицу
+        compareRows(fromTxt.tableModel(), fromSvb.tableModel());
+        QCOMPARE(Import::readSeriesHeaders(txtPath), extras.seriesHeaders);
+    }
+
+    void rejectsOtherVersion()
+    {
+        const QString path = m_dir.filePath("future.svb");
+        QVERIFY(Workspace::save(path, m_source->tableModel(), Workspace::Extras()));
+
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        const std::uint32_t version = Workspace::VERSION + 1;
+        QVERIFY(file.seek(offsetof(Workspace::FileHeader, version)));
+        QCOMPARE(file.write(reinterpret_cast<const char*>(&version), sizeof(version)), qint64(sizeof(version)));
+        file.close();
+
+        DataTable loaded(initialRowCount, initialColCount);
+        Workspace::Extras extras;
+        QString error;
+        QVERIFY(!Workspace::load(path, loaded.tableModel(), extras, error));
+        QVERIFY2(error.contains("версия"), qPrintable(error));
+        QCOMPARE(loaded.rowCount(), int(initialRowCount)); // Таблица не тронута
+    }
+
+    void rejectsRowsWithoutColumns()
+    {
+        // Разделы пусты, а заголовок обещает 2^32-1 рядов: таблица на них не выделяется
+        QByteArray text;
+        {
+            QDataStream out(&text, QIODevice::WriteOnly);
+            out.setVersion(QDataStream::Qt_6_0);
+            out << QStringList() << QStringList();
+        }
+        Workspace::FileHeader header{};
+        std::memcpy(header.magic, Workspace::MAGIC, sizeof(Workspace::MAGIC));
+        header.version = Workspace::VERSION;
+        header.rows = std::numeric_limits<std::uint32_t>::max();
+        header.textOffset = sizeof(header);
+        header.textSize = text.size();
+        header.fileSize = header.textOffset + header.textSize;
+
+        const QString path = m_dir.filePath("rows.svb");
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(text);
+        file.close();
+
+        DataTable loaded(initialRowCount, initialColCount);
+        Workspace::Extras extras;
+        QString error;
+        QVERIFY(!Workspace::load(path, loaded.tableModel(), extras, error));
+        QVERIFY2(error.contains("повреждён"), qPrintable(error));
+        QCOMPARE(loaded.rowCount(), int(initialRowCount));
+    }
+
+private:
+    QTemporaryDir m_dir;
+    DataTable* m_source = nullptr;
+    QStringList m_headers;
+};
+
+QTEST_MAIN(WorkspaceTest)
+#include "workspaceTest.moc"
@@ -0,0 +1,234 @@
+#include "workspace.h"
+
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Workspace
+{
+    namespace
+    {
+        std::uint64_t maskWords(std::uint64_t columns) { return (columns + 63) / 64; }
+
+        QStringList metricNames()
+        {
+            QStringList names;
+            for (const Metrics::Metric& metric : Metrics::registry())
+                names << metric.name;
+            return names;
+        }
+
+        bool writeRaw(QSaveFile& file, const void* data, std::uint64_t size)
+        {
+            return size == 0 || file.write(static_cast<const char*>(data), static_cast<qint64>(size)) == qint64(size);
+        }
+    }
+
+    bool isWorkspaceFile(const QString& path)
+    {
+        return QFileInfo(path).suffix().compare("svb", Qt::CaseInsensitive) == 0;
+    }
+
+    bool computeMetrics(const TableModel* model, QWidget* parent, QHash<int, QVector<double>>& metrics)
+    {
+        // Ряды копируются в потоке интерфейса: пока идёт расчёт, цикл событий
+        // работает и таблица может меняться, а пул читает только свои копии
+        QVector<int> rows;
+        QVector<std::vector<double>> rowsData;
+        for (int row = 0; row < model->rowCount(); ++row) {
+            if (model->valueCount(row) > 0) {
+                rows << row;
+                rowsData << model->rowValues(row);
+            }
+        }
+
+        QProgressDialog progress("Расчёт метрик...", "Отмена", 0, rows.size(), parent);
+        progress.setWindowTitle("Сохранение рабочей области");
+        progress.setWindowModality(Qt::WindowModal);
+        progress.setMinimumDuration(300);
+
+        QFutureWatcher<QVector<double>> watcher;
+        QEventLoop loop;
+        QObject::connect(&watcher, &QFutureWatcherBase::progressValueChanged,
+                         &progress, &QProgressDialog::setValue);
+        QObject::connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
+        QObject::connect(&progress, &QProgressDialog::canceled, &watcher, &QFutureWatcherBase::cancel);
+
+        watcher.setFuture(QtConcurrent::mapped(rowsData, [](const std::vector<double>& values) {
+            return Metrics::evaluate(values);
+        }));
+        loop.exec();
+        watcher.waitForFinished();
+        progress.reset();
+
+        if (watcher.isCanceled()) return false;
+
+        const QList<QVector<double>> results = watcher.future().results();
+        metrics.clear();
+        for (int i = 0; i < rows.size(); ++i)
+            metrics.insert(rows[i], results[i]);
+        return true;
+    }
+
+    bool save(const QString& path, const TableModel* model, const Extras& extras)
+    {
+        const std::uint64_t rows = model->rowCount();
+        const std::uint64_t columns = model->columnCount();
+        const std::uint64_t words = maskWords(columns);
+        const QStringList names = metricNames();
+        const std::uint64_t metricCount = names.size();
+        if (rows > 0 && columns == 0) return false; // Такой файл load отвергнет
+
+        QByteArray text;
+        {
+            QDataStream out(&text, QIODevice::WriteOnly);
+            out.setVersion(QDataStream::Qt_6_0);
+            out << extras.seriesHeaders << names;
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.rows = static_cast<std::uint32_t>(rows);
+        header.columns = static_cast<std::uint32_t>(columns);
+        header.metricCount = static_cast<std::uint32_t>(metricCount);
+        header.textOffset = sizeof(FileHeader) + rows * (columns + words + metricCount) * 8;
+        header.textSize = text.size();
+        header.fileSize = header.textOffset + header.textSize;
+
+        // QSaveFile подменяет файл только после успешной записи целиком
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return false;
+
+        bool ok = writeRaw(file, &header, sizeof(header));
+        for (std::uint64_t row = 0; ok && row < rows; ++row)
+            ok = writeRaw(file, model->rowData(row), columns * sizeof(double));
+        for (std::uint64_t row = 0; ok && row < rows; ++row)
+            ok = writeRaw(file, model->rowMask(row), words * sizeof(std::uint64_t));
+
+        const std::vector<double> missing(metricCount, std::numeric_limits<double>::quiet_NaN());
+        for (std::uint64_t row = 0; ok && row < rows; ++row) {
+            const QVector<double> values = extras.metrics.value(static_cast<int>(row));
+            ok = writeRaw(file, values.size() == qsizetype(metricCount) ? values.constData() : missing.data(),
+                          metricCount * sizeof(double));
+        }
+        ok = ok && writeRaw(file, text.constData(), text.size());
+        return ok && file.commit();
+    }
+
+    bool load(const QString& path, TableModel* model, Extras& extras, QString& error)
+    {
+        if (Q_BYTE_ORDER != Q_LITTLE_ENDIAN) {
+            error = "Формат .svb поддерживается только на little-endian системах.";
+            return false;
+        }
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            error = "Не удалось открыть файл.";
+            return false;
+        }
+
+        const std::uint64_t size = file.size();
+        if (size < sizeof(FileHeader)) {
+            error = "Файл повреждён или не является рабочей областью.";
+            return false;
+        }
+
+        // Если файл не отображается в память, он читается целиком в буфер
+        // из 8-байтовых слов, чтобы числовые разделы остались выровненными
+        std::vector<std::uint64_t> buffer;
+        const uchar* data = file.map(0, file.size());
+        if (!data) {
+            buffer.resize((size + 7) / 8);
+            if (file.read(reinterpret_cast<char*>(buffer.data()), file.size()) != file.size()) {
+                error = "Не удалось прочитать файл.";
+                return false;
+            }
+            data = reinterpret_cast<const uchar*>(buffer.data());
+        }
+
+        // Версия проверяется раньше разметки: у другой версии разделы могут лежать иначе
+        FileHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            error = "Файл не является рабочей областью.";
+            return false;
+        }
+        if (header.version != VERSION) {
+            error = QString("Неподдерживаемая версия рабочей области: %1.").arg(header.version);
+            return false;
+        }
+
+        // Размеры разделов проверяются до чтения: повреждённый файл не выводит за его границы
+        const std::uint64_t rows = header.rows;
+        const std::uint64_t columns = header.columns;
+        const std::uint64_t words = maskWords(columns);
+        const std::uint64_t metricCount = header.metricCount;
+        const std::uint64_t perRow = columns + words + metricCount;
+        const std::uint64_t available = (size - sizeof(FileHeader)) / 8;
+        // Без столбцов разделы пусты при любом числе рядов, поэтому такая
+        // таблица (интерфейс её не создаёт) отвергается до выделения памяти под ряды
+        if (header.fileSize != size
+            || rows > std::uint64_t(std::numeric_limits<int>::max())
+            || columns > std::uint64_t(std::numeric_limits<int>::max())
+            || (rows > 0 && columns == 0)
+            || (rows > 0 && perRow > available / rows)
+            || header.textOffset != sizeof(FileHeader) + rows * perRow * 8
+            || header.textSize != size - header.textOffset) {
+            error = "Файл повреждён.";
+            return false;
+        }
+
+        const double* values = reinterpret_cast<const double*>(data + sizeof(FileHeader));
+        const std::uint64_t* masks = reinterpret_cast<const std::uint64_t*>(values + rows * columns);
+        const double* metrics = reinterpret_cast<const double*>(masks + rows * words);
+
+        QStringList names;
+        {
+            const QByteArray text = QByteArray::fromRawData(reinterpret_cast<const char*>(data + header.textOffset),
+                                                            static_cast<qsizetype>(header.textSize));
+            QDataStream in(text);
+            in.setVersion(QDataStream::Qt_6_0);
+            in >> extras.seriesHeaders >> names;
+            if (in.status() != QDataStream::Ok) {
+                error = "Файл повреждён.";
+                return false;
+            }
+        }
+
+        // Значения копируются блоком; маска решает, где пропуск, даже если в файле там не nan
+        std::vector<std::vector<double>> table(rows);
+        for (std::uint64_t row = 0; row < rows; ++row) {
+            const double* source = values + row * columns;
+            const std::uint64_t* mask = masks + row * words;
+            std::vector<double>& target = table[row];
+            target.assign(source, source + columns);
+            for (std::uint64_t word = 0; word < words; ++word) {
+                if (mask[word] == ~std::uint64_t(0)) continue;
+                const std::uint64_t end = std::min(columns, (word + 1) * 64);
+                for (std::uint64_t col = word * 64; col < end; ++col) {
+                    if (!(mask[word] >> (col & 63) & 1))
+                        target[col] = std::numeric_limits<double>::quiet_NaN();
+                }
+            }
+        }
+
+        // Метрики берутся в кэш, только если реестр тот же, что при сохранении
+        extras.metrics.clear();
+        if (names == metricNames()) {
+            for (std::uint64_t row = 0; row < rows; ++row) {
+                const std::uint64_t* mask = masks + row * words;
+                const bool hasValues = std::any_of(mask, mask + words, [](std::uint64_t word) { return word != 0; });
+                if (!hasValues) continue;
+                const double* source = metrics + row * metricCount;
+                extras.metrics.insert(static_cast<int>(row), QVector<double>(source, source + metricCount));
+            }
+        }
+
+        model->loadRows(std::move(table), static_cast<int>(columns));
+        return true;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QHash>
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QtConcurrent>
+#include <QStringList>
+#include <QVector>
+
+#include "metrics.h"
+#include "tableModel.h"
+
+#include <cstdint>
+
+// Двоичная рабочая область (.svb): ряды таблицы как есть — массивы double по
+// всем столбцам и битовые маски заполненных ячеек, затем посчитанные метрики
+// и текстовый блок с заголовками рядов. Числовые разделы выровнены по 8 байт
+// и читаются прямо из отображённого в память файла.
+//
+//   FileHeader
+//   double   values[rows][columns]      nan на месте пропуска
+//   uint64   mask[rows][(columns+63)/64]
+//   double   metrics[rows][metricCount]  в порядке реестра, nan для пустого ряда
+//   QDataStream: QStringList seriesHeaders, QStringList metricNames
+namespace Workspace
+{
+    constexpr char MAGIC[4] = {'S', 'V', 'B', '\0'};
+    constexpr std::uint32_t VERSION = 1;
+
+    struct FileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t rows;
+        std::uint32_t columns;
+        std::uint32_t metricCount;
+        std::uint32_t reserved;
+        std::uint64_t textOffset;
+        std::uint64_t textSize;
+        std::uint64_t fileSize;
+    };
+    static_assert(sizeof(FileHeader) == 48, "Заголовок файла должен быть плотным");
+
+    // Содержимое файла помимо самой таблицы
+    struct Extras
+    {
+        QStringList seriesHeaders;
+        QHash<int, QVector<double>> metrics; // Только для непустых рядов
+    };
+
+    bool isWorkspaceFile(const QString& path);
+
+    // Метрики всех непустых рядов считаются в пуле потоков; false — отменено
+    bool computeMetrics(const TableModel* model, QWidget* parent, QHash<int, QVector<double>>& metrics);
+    bool save(const QString& path, const TableModel* model, const Extras& extras);
+    bool load(const QString& path, TableModel* model, Extras& extras, QString& error);
+}
+
+#endif // WORKSPACE_H